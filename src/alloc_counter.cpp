@@ -0,0 +1,141 @@
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+// One counter slot per thread, on its own cache line so counting does not bounce
+// lines between cores. Threads beyond MAX_SLOTS share slots, hence the atomics.
+static const int MAX_SLOTS = 256;
+
+struct alignas(64) AllocSlot {
+    std::atomic<long long> allocations;
+    std::atomic<long long> bytes;
+};
+
+static AllocSlot slots[MAX_SLOTS];
+static std::atomic<int> nextSlot(0);
+
+static AllocSlot& threadSlot() {
+    thread_local AllocSlot* slot = &slots[nextSlot.fetch_add(1, std::memory_order_relaxed) % MAX_SLOTS];
+    return *slot;
+}
+
+static void* countedAlloc(std::size_t size, std::size_t alignment = 0) {
+    AllocSlot& slot = threadSlot();
+    slot.allocations.fetch_add(1, std::memory_order_relaxed);
+    slot.bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* pointer = nullptr;
+    if (alignment > alignof(std::max_align_t)) {
+        // aligned_alloc requires the size to be a multiple of the alignment
+        pointer = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    } else {
+        pointer = std::malloc(size);
+    }
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new(std::size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+// Current totals
+AllocCounts allocCountsNow() {
+    AllocCounts counts;
+    for (int i = 0; i < MAX_SLOTS; ++i) {
+        counts.allocations += slots[i].allocations.load(std::memory_order_relaxed);
+        counts.bytes += slots[i].bytes.load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+// Peak resident set size of the process in KB
+long long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::atoll(line.c_str() + 6);
+        }
+    }
+    return -1;
+}
+
+// Writing 5 to clear_refs resets VmHWM to the current RSS (Linux 4.0+)
+bool resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (!clearRefs.is_open()) {
+        return false;
+    }
+    clearRefs << "5";
+    clearRefs.flush();
+    return static_cast<bool>(clearRefs);
+}
@@ -0,0 +1,33 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+// Heap allocation counting for benchmark builds. alloc_counter.cpp replaces the
+// global operator new / delete with versions that count calls and requested bytes
+// per thread; link it only into benchmark executables (performance_analysis).
+
+// Allocations and requested bytes since process start, summed over all threads
+struct AllocCounts {
+    long long allocations;
+    long long bytes;
+
+    AllocCounts() : allocations(0), bytes(0) {}
+
+    AllocCounts operator-(const AllocCounts& earlier) const {
+        AllocCounts diff;
+        diff.allocations = allocations - earlier.allocations;
+        diff.bytes = bytes - earlier.bytes;
+        return diff;
+    }
+};
+
+// Current totals (take two snapshots and subtract them to measure an interval)
+AllocCounts allocCountsNow();
+
+// Peak resident set size of the process in KB (VmHWM), -1 where unavailable
+long long peakRssKb();
+
+// Reset the peak resident set size to the current size, so the next peakRssKb()
+// covers only what follows. Returns false where the kernel does not support it.
+bool resetPeakRss();
+
+#endif // ALLOC_COUNTER_H
@@ -0,0 +1,111 @@
+#include "baseline.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+// Key identifying a configuration across runs
+std::string baselineKey(const std::string& puzzleName, const std::string& strategy,
+                        int numThreads, int partitionDepth) {
+    return puzzleName + "|" + strategy + "|" + std::to_string(numThreads) + "|" + std::to_string(partitionDepth);
+}
+
+// Split one CSV line into fields
+std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> fields;
+    std::string field;
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else if (c != '\r') {
+            field += c;
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+// Index of a header column, -1 if missing
+static int columnIndex(const std::vector<std::string>& header, const std::string& name) {
+    for (size_t i = 0; i < header.size(); ++i) {
+        if (header[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Load a performance_results.csv written by an earlier run
+bool loadBaselineFile(const std::string& path, std::map<std::string, BaselineEntry>& entries) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open baseline file " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line)) {
+        std::cerr << "Error: Baseline file " << path << " is empty" << std::endl;
+        return false;
+    }
+    std::vector<std::string> header = splitCsvLine(line);
+    int puzzleColumn = columnIndex(header, "Puzzle");
+    int strategyColumn = columnIndex(header, "Strategy");
+    int threadsColumn = columnIndex(header, "Threads");
+    int depthColumn = columnIndex(header, "Partition Depth");
+    int timeColumn = columnIndex(header, "Execution Time (ms)");
+    int nodesColumn = columnIndex(header, "Nodes");
+    int samplesColumn = columnIndex(header, "Samples (ms)");
+    if (puzzleColumn < 0 || strategyColumn < 0 || threadsColumn < 0 || depthColumn < 0 || timeColumn < 0) {
+        std::cerr << "Error: " << path << " is not a performance_results.csv file" << std::endl;
+        return false;
+    }
+
+    int lineNumber = 1;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty()) {
+            continue;
+        }
+        std::vector<std::string> fields = splitCsvLine(line);
+        if (fields.size() != header.size()) {
+            std::cerr << "Warning: Skipping line " << lineNumber << " of " << path
+                      << " (expected " << header.size() << " fields, found " << fields.size() << ")" << std::endl;
+            continue;
+        }
+
+        BaselineEntry entry;
+        entry.puzzleName = fields[puzzleColumn];
+        entry.strategy = fields[strategyColumn];
+        entry.numThreads = std::atoi(fields[threadsColumn].c_str());
+        entry.partitionDepth = std::atoi(fields[depthColumn].c_str());
+        entry.medianMs = std::atof(fields[timeColumn].c_str());
+        entry.nodes = (nodesColumn >= 0 && !fields[nodesColumn].empty())
+                    ? std::atoll(fields[nodesColumn].c_str()) : -1;
+        if (samplesColumn >= 0) {
+            std::istringstream samples(fields[samplesColumn]);
+            std::string sample;
+            while (std::getline(samples, sample, ';')) {
+                if (!sample.empty()) {
+                    entry.samples.push_back(std::atof(sample.c_str()));
+                }
+            }
+        }
+        entries[baselineKey(entry.puzzleName, entry.strategy, entry.numThreads, entry.partitionDepth)] = entry;
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+// One configuration of a stored performance_results.csv
+struct BaselineEntry {
+    std::string puzzleName;
+    std::string strategy;
+    int numThreads;
+    int partitionDepth;
+    double medianMs;              // Median execution time
+    long long nodes;              // Search nodes (-1 if the file has no node column)
+    std::vector<double> samples;  // Time of every repetition (empty in files written before samples were stored)
+};
+
+// Key identifying a configuration across runs
+std::string baselineKey(const std::string& puzzleName, const std::string& strategy,
+                        int numThreads, int partitionDepth);
+
+// Split one CSV line into fields; quoted fields may contain commas and doubled quotes
+std::vector<std::string> splitCsvLine(const std::string& line);
+
+// Load a performance_results.csv written by an earlier run, keyed by baselineKey
+bool loadBaselineFile(const std::string& path, std::map<std::string, BaselineEntry>& entries);
+
+#endif // BASELINE_H
@@ -0,0 +1,219 @@
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "solver_stats.h"
+#include "bit_utils.h"
+
+// Percentile p (0..100) of an ascending-sorted sample, by linear interpolation
+inline double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    double rank = (p / 100.0) * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(std::floor(rank));
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+    double fraction = rank - lower;
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+// Min / median / p99 / max of a sample
+struct Distribution {
+    double min;
+    double median;
+    double p99;
+    double max;
+    double mean;
+    double topShare;  // Share of the total held by the largest 1% of entries (at least one)
+
+    Distribution() : min(0.0), median(0.0), p99(0.0), max(0.0), mean(0.0), topShare(0.0) {}
+};
+
+inline Distribution summarize(std::vector<double> values) {
+    Distribution dist;
+    if (values.empty()) {
+        return dist;
+    }
+
+    std::sort(values.begin(), values.end());
+    double total = 0.0;
+    for (double value : values) {
+        total += value;
+    }
+
+    size_t topCount = std::max<size_t>(1, values.size() / 100);
+    double topTotal = 0.0;
+    for (size_t i = values.size() - topCount; i < values.size(); ++i) {
+        topTotal += values[i];
+    }
+
+    dist.min = values.front();
+    dist.median = percentile(values, 50.0);
+    dist.p99 = percentile(values, 99.0);
+    dist.max = values.back();
+    dist.mean = total / values.size();
+    dist.topShare = (total > 0.0) ? topTotal / total : 0.0;
+    return dist;
+}
+
+// Sample mean and standard deviation (n - 1 denominator)
+inline double mean(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (double value : values) {
+        total += value;
+    }
+    return total / values.size();
+}
+
+inline double stddev(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    double average = mean(values);
+    double sumSquares = 0.0;
+    for (double value : values) {
+        sumSquares += (value - average) * (value - average);
+    }
+    return std::sqrt(sumSquares / (values.size() - 1));
+}
+
+inline double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return percentile(values, 50.0);
+}
+
+// Median of a bootstrap resample (drawn with replacement)
+inline double resampleMedian(const std::vector<double>& values, SplitMix64& rng, std::vector<double>& scratch) {
+    scratch.resize(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        scratch[i] = values[rng.below(static_cast<uint32_t>(values.size()))];
+    }
+    std::sort(scratch.begin(), scratch.end());
+    return percentile(scratch, 50.0);
+}
+
+// Percentile bootstrap confidence interval of the median
+inline void bootstrapMedianCI(const std::vector<double>& values, double confidence, int resamples,
+                              uint64_t seed, double& low, double& high) {
+    low = high = median(values);
+    if (values.size() < 2 || resamples <= 0) {
+        return;
+    }
+    SplitMix64 rng(seed);
+    std::vector<double> medians(resamples);
+    std::vector<double> scratch;
+    for (int r = 0; r < resamples; ++r) {
+        medians[r] = resampleMedian(values, rng, scratch);
+    }
+    std::sort(medians.begin(), medians.end());
+    low = percentile(medians, (1.0 - confidence) / 2.0 * 100.0);
+    high = percentile(medians, (1.0 + confidence) / 2.0 * 100.0);
+}
+
+// Percentile bootstrap confidence interval of median(numerator) / median(denominator),
+// resampling both samples independently (used for speedups)
+inline void bootstrapRatioCI(const std::vector<double>& numerator, const std::vector<double>& denominator,
+                             double confidence, int resamples, uint64_t seed, double& low, double& high) {
+    double point = median(denominator) > 0.0 ? median(numerator) / median(denominator) : 0.0;
+    low = high = point;
+    if (numerator.size() < 2 || denominator.size() < 2 || resamples <= 0) {
+        return;
+    }
+    SplitMix64 rng(seed);
+    std::vector<double> ratios;
+    ratios.reserve(resamples);
+    std::vector<double> scratch;
+    for (int r = 0; r < resamples; ++r) {
+        double top = resampleMedian(numerator, rng, scratch);
+        double bottom = resampleMedian(denominator, rng, scratch);
+        if (bottom > 0.0) {
+            ratios.push_back(top / bottom);
+        }
+    }
+    if (ratios.empty()) {
+        return;
+    }
+    std::sort(ratios.begin(), ratios.end());
+    low = percentile(ratios, (1.0 - confidence) / 2.0 * 100.0);
+    high = percentile(ratios, (1.0 + confidence) / 2.0 * 100.0);
+}
+
+// Summary of repeated timings of one configuration
+struct TimingSummary {
+    int repetitions;
+    double median;
+    double p95;
+    double mean;
+    double stddev;
+    double ciLow;   // Bootstrap confidence interval of the median
+    double ciHigh;
+
+    TimingSummary()
+        : repetitions(0), median(0.0), p95(0.0), mean(0.0), stddev(0.0), ciLow(0.0), ciHigh(0.0) {}
+};
+
+inline TimingSummary summarizeTimings(const std::vector<double>& samples, double confidence,
+                                      int resamples, uint64_t seed) {
+    TimingSummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    summary.repetitions = static_cast<int>(samples.size());
+    summary.median = percentile(sorted, 50.0);
+    summary.p95 = percentile(sorted, 95.0);
+    summary.mean = mean(samples);
+    summary.stddev = stddev(samples);
+    bootstrapMedianCI(samples, confidence, resamples, seed, summary.ciLow, summary.ciHigh);
+    return summary;
+}
+
+// Load balance of one parallel solve, from the per-task records and per-thread totals
+struct ImbalanceSummary {
+    int numSubproblems;
+    Distribution durationMs;  // Per-subproblem wall time
+    Distribution nodes;       // Per-subproblem search nodes
+    double maxBusyMs;         // Busiest thread
+    double meanBusyMs;        // Average thread
+    double totalIdleMs;       // Idle time summed over threads
+
+    // Busiest thread relative to the average (1.0 = perfectly balanced)
+    double imbalanceFactor() const {
+        return (meanBusyMs > 0.0) ? maxBusyMs / meanBusyMs : 1.0;
+    }
+};
+
+inline ImbalanceSummary summarizeImbalance(const SolverStats& stats) {
+    ImbalanceSummary summary;
+    summary.numSubproblems = static_cast<int>(stats.subproblems.size());
+
+    std::vector<double> durations;
+    std::vector<double> nodes;
+    durations.reserve(stats.subproblems.size());
+    nodes.reserve(stats.subproblems.size());
+    for (const SubproblemRecord& record : stats.subproblems) {
+        durations.push_back(record.durationMs);
+        nodes.push_back(static_cast<double>(record.nodes));
+    }
+    summary.durationMs = summarize(durations);
+    summary.nodes = summarize(nodes);
+
+    summary.maxBusyMs = 0.0;
+    summary.totalIdleMs = 0.0;
+    double totalBusy = 0.0;
+    for (const ThreadStats& thread : stats.perThread) {
+        summary.maxBusyMs = std::max(summary.maxBusyMs, thread.busyMs);
+        summary.totalIdleMs += thread.idleMs;
+        totalBusy += thread.busyMs;
+    }
+    summary.meanBusyMs = stats.perThread.empty() ? 0.0 : totalBusy / stats.perThread.size();
+    return summary;
+}
+
+#endif // BENCH_STATS_H
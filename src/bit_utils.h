@@ -0,0 +1,73 @@
+#ifndef BIT_UTILS_H
+#define BIT_UTILS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Number of set bits in a candidate mask
+inline int popcount64(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Index of the lowest set bit (mask must be non-zero)
+inline int lowestBit64(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Index of the n-th (0-based) set bit of mask (mask must have more than n bits set)
+inline int nthBit64(uint64_t mask, int n) {
+    for (int i = 0; i < n; ++i) {
+        mask &= mask - 1;
+    }
+    return lowestBit64(mask);
+}
+
+// Element of the Luby sequence 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ... (index from 0)
+inline long long lubyTerm(int index) {
+    long long size = 1;
+    int exponent = 0;
+    while (size < index + 1) {
+        ++exponent;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) >> 1;
+        --exponent;
+        index = static_cast<int>(index % size);
+    }
+    return 1LL << exponent;
+}
+
+// Small, fast pseudo-random generator (SplitMix64) for reproducible randomized searches
+struct SplitMix64 {
+    uint64_t state;
+
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform integer in [0, bound)
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+};
+
+#endif // BIT_UTILS_H
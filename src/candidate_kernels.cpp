@@ -0,0 +1,399 @@
+#include "candidate_kernels.h"
+
+#include "bit_utils.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+
+// Versions for several instruction sets in one binary need GCC/Clang function
+// target attributes and CPU detection; other compilers get the scalar kernels only
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SUDOKU_KERNEL_DISPATCH 1
+#include <immintrin.h>
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#define KERNEL_INLINE inline __attribute__((always_inline))
+#define TARGET_SSE42 "sse4.2,popcnt"
+#define TARGET_AVX2 "avx2,bmi,bmi2,lzcnt,popcnt"
+#define TARGET_AVX512 "avx512f,avx512bw,avx512vl,avx2,bmi,bmi2,lzcnt,popcnt"
+#else
+#define SUDOKU_KERNEL_DISPATCH 0
+#define KERNEL_INLINE inline
+#endif
+
+// Mask of the values 1..N
+static inline uint64_t valueMask(int N) {
+    return ((N >= 63) ? ~0ull : ((1ull << (N + 1)) - 1)) & ~1ull;
+}
+
+// One cell at a time; inlined into each target so the compiler may vectorize it
+static KERNEL_INLINE void computeAllCandidatesLoop(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                                                   const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out) {
+    const uint64_t fullMask = valueMask(N);
+    for (int row = 0; row < N; ++row) {
+        const int* cells = board + row * N;
+        uint64_t* rowOut = out + row * N;
+        const uint64_t* bandBlocks = blockMask + (row / blockSize) * blockSize;
+        for (int col = 0; col < N; ++col) {
+            uint64_t used = rowMask[row] | colMask[col] | bandBlocks[col / blockSize];
+            rowOut[col] = (cells[col] == 0) ? (fullMask & ~used) : 0;
+        }
+    }
+}
+
+// Portable implementation, one cell at a time
+void computeAllCandidatesScalar(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                                const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out) {
+    computeAllCandidatesLoop(board, N, blockSize, rowMask, colMask, blockMask, out);
+}
+
+// Scalar scan; popcount64 becomes a POPCNT instruction in the targets that have it
+static KERNEL_INLINE void scanCandidatesLoop(const uint64_t* candidates, const int* board, int numCells,
+                                             int* singles, CandidateScan& scan) {
+    scan.numEmpty = 0;
+    scan.numSingles = 0;
+    scan.contradiction = -1;
+    scan.branchCell = -1;
+    scan.fewest = INT_MAX;
+    for (int cell = 0; cell < numCells; ++cell) {
+        if (board[cell] != 0) {
+            continue;
+        }
+        ++scan.numEmpty;
+        int count = popcount64(candidates[cell]);
+        if (count == 0) {
+            scan.contradiction = cell;
+            return;
+        }
+        if (count == 1) {
+            singles[scan.numSingles++] = cell;
+        } else if (count < scan.fewest) {
+            scan.fewest = count;
+            scan.branchCell = cell;
+        }
+    }
+}
+
+static void scanCandidatesScalar(const uint64_t* candidates, const int* board, int numCells, int* singles,
+                                 CandidateScan& scan) {
+    scanCandidatesLoop(candidates, board, numCells, singles, scan);
+}
+
+#if SUDOKU_KERNEL_DISPATCH
+// SSE4.2 level: the scalar loops compiled with POPCNT
+KERNEL_TARGET(TARGET_SSE42)
+static void computeAllCandidatesSse42(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                                      const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out) {
+    computeAllCandidatesLoop(board, N, blockSize, rowMask, colMask, blockMask, out);
+}
+
+KERNEL_TARGET(TARGET_SSE42)
+static void scanCandidatesSse42(const uint64_t* candidates, const int* board, int numCells, int* singles,
+                                CandidateScan& scan) {
+    scanCandidatesLoop(candidates, board, numCells, singles, scan);
+}
+
+// Block column of every column, used as gather indices
+static void blockColumns(int N, int blockSize, long long* blockCol) {
+    for (int col = 0; col < N; ++col) {
+        blockCol[col] = col / blockSize;
+    }
+}
+
+// Four cells per step: column masks are loaded contiguously, block masks gathered,
+// and filled cells are cleared with a lane mask built from the board values
+KERNEL_TARGET(TARGET_AVX2)
+static void computeAllCandidatesAvx2(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                                     const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out) {
+    const uint64_t fullMask = valueMask(N);
+    const __m256i full = _mm256_set1_epi64x(static_cast<long long>(fullMask));
+    alignas(32) long long blockCol[64];
+    blockColumns(N, blockSize, blockCol);
+
+    for (int row = 0; row < N; ++row) {
+        const int* cells = board + row * N;
+        uint64_t* rowOut = out + row * N;
+        const long long* bandBlocks = reinterpret_cast<const long long*>(blockMask + (row / blockSize) * blockSize);
+        const __m256i rowUsed = _mm256_set1_epi64x(static_cast<long long>(rowMask[row]));
+
+        int col = 0;
+        for (; col + 4 <= N; col += 4) {
+            __m256i cols = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colMask + col));
+            __m256i blockIndex = _mm256_load_si256(reinterpret_cast<const __m256i*>(blockCol + col));
+            __m256i blocks = _mm256_i64gather_epi64(bandBlocks, blockIndex, 8);
+            __m256i used = _mm256_or_si256(rowUsed, _mm256_or_si256(cols, blocks));
+
+            // All-ones lanes for empty cells (value 0), widened from 32 to 64 bits
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + col));
+            __m256i empty = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(values, _mm_setzero_si128()));
+
+            __m256i candidates = _mm256_and_si256(_mm256_andnot_si256(used, full), empty);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rowOut + col), candidates);
+        }
+        for (; col < N; ++col) {
+            uint64_t used = rowMask[row] | colMask[col] | static_cast<uint64_t>(bandBlocks[col / blockSize]);
+            rowOut[col] = (cells[col] == 0) ? (fullMask & ~used) : 0;
+        }
+    }
+}
+
+// A table-lookup popcount over four lanes measured slower than POPCNT per cell, so
+// the AVX2 level scans with the scalar loop (POPCNT, TZCNT)
+KERNEL_TARGET(TARGET_AVX2)
+static void scanCandidatesAvx2(const uint64_t* candidates, const int* board, int numCells, int* singles,
+                               CandidateScan& scan) {
+    scanCandidatesLoop(candidates, board, numCells, singles, scan);
+}
+
+// Eight cells per step, with the empty-cell lane mask in a k register
+KERNEL_TARGET(TARGET_AVX512)
+static void computeAllCandidatesAvx512(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                                       const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out) {
+    const uint64_t fullMask = valueMask(N);
+    const __m512i full = _mm512_set1_epi64(static_cast<long long>(fullMask));
+    alignas(64) long long blockCol[64];
+    blockColumns(N, blockSize, blockCol);
+
+    for (int row = 0; row < N; ++row) {
+        const int* cells = board + row * N;
+        uint64_t* rowOut = out + row * N;
+        const uint64_t* bandBlocks = blockMask + (row / blockSize) * blockSize;
+        const __m512i rowUsed = _mm512_set1_epi64(static_cast<long long>(rowMask[row]));
+
+        int col = 0;
+        for (; col + 8 <= N; col += 8) {
+            __m512i cols = _mm512_loadu_si512(colMask + col);
+            __m512i blockIndex = _mm512_load_si512(blockCol + col);
+            __m512i blocks = _mm512_i64gather_epi64(blockIndex, bandBlocks, 8);
+            __m512i used = _mm512_or_si512(rowUsed, _mm512_or_si512(cols, blocks));
+
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + col));
+            __mmask8 empty = _mm256_cmpeq_epi32_mask(values, _mm256_setzero_si256());
+            _mm512_storeu_si512(rowOut + col, _mm512_maskz_andnot_epi64(empty, used, full));
+        }
+        for (; col < N; ++col) {
+            uint64_t used = rowMask[row] | colMask[col] | bandBlocks[col / blockSize];
+            rowOut[col] = (cells[col] == 0) ? (fullMask & ~used) : 0;
+        }
+    }
+}
+
+// Popcount of eight 64-bit lanes (AVX512-BW table lookups; VPOPCNTQ is a later extension)
+KERNEL_TARGET(TARGET_AVX512)
+static inline __m512i popcountLanesAvx512(__m512i v) {
+    const __m512i table = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i lowNibble = _mm512_set1_epi8(0x0f);
+    __m512i low = _mm512_shuffle_epi8(table, _mm512_and_si512(v, lowNibble));
+    __m512i high = _mm512_shuffle_epi8(table, _mm512_and_si512(_mm512_srli_epi16(v, 4), lowNibble));
+    return _mm512_sad_epu8(_mm512_add_epi8(low, high), _mm512_setzero_si512());
+}
+
+KERNEL_TARGET(TARGET_AVX512)
+static void scanCandidatesAvx512(const uint64_t* candidates, const int* board, int numCells, int* singles,
+                                 CandidateScan& scan) {
+    scan.numEmpty = 0;
+    scan.numSingles = 0;
+    scan.contradiction = -1;
+    scan.branchCell = -1;
+    scan.fewest = INT_MAX;
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i none = _mm512_set1_epi64(LLONG_MAX);
+
+    int cell = 0;
+    for (; cell + 8 <= numCells; cell += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(board + cell));
+        __mmask8 empty = _mm256_cmpeq_epi32_mask(values, _mm256_setzero_si256());
+        if (empty == 0) {
+            continue;
+        }
+        __m512i count = popcountLanesAvx512(_mm512_loadu_si512(candidates + cell));
+        __mmask8 isZero = _mm512_mask_cmpeq_epi64_mask(empty, count, zero);
+        __mmask8 isOne = _mm512_mask_cmpeq_epi64_mask(empty, count, one);
+        scan.numEmpty += __builtin_popcount(empty);
+        if (isZero) {
+            scan.contradiction = cell + __builtin_ctz(isZero);
+            return;
+        }
+        for (unsigned bits = isOne; bits != 0; bits &= bits - 1) {
+            singles[scan.numSingles++] = cell + __builtin_ctz(bits);
+        }
+        // Fewest candidates among the remaining empty cells, first lane on ties
+        __mmask8 branching = empty & ~isOne;
+        if (branching) {
+            __m512i branchCounts = _mm512_mask_blend_epi64(branching, none, count);
+            long long least = _mm512_reduce_min_epi64(branchCounts);
+            if (least < scan.fewest) {
+                __mmask8 lanes = _mm512_mask_cmpeq_epi64_mask(branching, branchCounts, _mm512_set1_epi64(least));
+                scan.fewest = static_cast<int>(least);
+                scan.branchCell = cell + __builtin_ctz(lanes);
+            }
+        }
+    }
+    for (; cell < numCells; ++cell) {
+        if (board[cell] != 0) {
+            continue;
+        }
+        ++scan.numEmpty;
+        int count = popcount64(candidates[cell]);
+        if (count == 0) {
+            scan.contradiction = cell;
+            return;
+        }
+        if (count == 1) {
+            singles[scan.numSingles++] = cell;
+        } else if (count < scan.fewest) {
+            scan.fewest = count;
+            scan.branchCell = cell;
+        }
+    }
+}
+#endif
+
+static const KernelTable kernelTables[NUM_KERNEL_PATHS] = {
+    {KERNEL_SCALAR, "scalar", computeAllCandidatesScalar, scanCandidatesScalar},
+#if SUDOKU_KERNEL_DISPATCH
+    {KERNEL_SSE42, "sse4.2", computeAllCandidatesSse42, scanCandidatesSse42},
+    {KERNEL_AVX2, "avx2", computeAllCandidatesAvx2, scanCandidatesAvx2},
+    {KERNEL_AVX512, "avx512", computeAllCandidatesAvx512, scanCandidatesAvx512},
+#else
+    {KERNEL_SSE42, "sse4.2", nullptr, nullptr},
+    {KERNEL_AVX2, "avx2", nullptr, nullptr},
+    {KERNEL_AVX512, "avx512", nullptr, nullptr},
+#endif
+};
+
+// Whether the CPU (and the OS, for the wide registers) supports a level
+static bool cpuSupports(KernelPath path) {
+#if SUDOKU_KERNEL_DISPATCH
+    __builtin_cpu_init();
+    switch (path) {
+    case KERNEL_SCALAR:
+        return true;
+    case KERNEL_SSE42:
+        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    case KERNEL_AVX2:
+        return cpuSupports(KERNEL_SSE42) && __builtin_cpu_supports("avx2")
+            && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+    case KERNEL_AVX512:
+        return cpuSupports(KERNEL_AVX2) && __builtin_cpu_supports("avx512f")
+            && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl");
+    default:
+        return false;
+    }
+#else
+    return path == KERNEL_SCALAR;
+#endif
+}
+
+const KernelTable* getKernelTable(KernelPath path) {
+    if (path < 0 || path >= NUM_KERNEL_PATHS || !kernelTables[path].computeAllCandidates || !cpuSupports(path)) {
+        return nullptr;
+    }
+    return &kernelTables[path];
+}
+
+static const KernelTable& selectKernels() {
+    int best = KERNEL_SCALAR;
+    for (int path = KERNEL_SCALAR; path < NUM_KERNEL_PATHS; ++path) {
+        if (getKernelTable(static_cast<KernelPath>(path))) {
+            best = path;
+        }
+    }
+
+    const char* requested = std::getenv("SUDOKU_KERNEL_PATH");
+    if (requested && *requested) {
+        for (int path = KERNEL_SCALAR; path < NUM_KERNEL_PATHS; ++path) {
+            if (std::strcmp(requested, kernelTables[path].name) != 0) {
+                continue;
+            }
+            if (const KernelTable* table = getKernelTable(static_cast<KernelPath>(path))) {
+                return *table;
+            }
+            std::cerr << "Warning: SUDOKU_KERNEL_PATH=" << requested << " is not supported here, using "
+                      << kernelTables[best].name << std::endl;
+            return kernelTables[best];
+        }
+        std::cerr << "Warning: Unknown SUDOKU_KERNEL_PATH=" << requested
+                  << " (expected scalar, sse4.2, avx2 or avx512), using " << kernelTables[best].name << std::endl;
+    }
+    return kernelTables[best];
+}
+
+const KernelTable& getActiveKernels() {
+    static const KernelTable& active = selectKernels();
+    return active;
+}
+
+void computeAllCandidates(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                          const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out) {
+    getActiveKernels().computeAllCandidates(board, N, blockSize, rowMask, colMask, blockMask, out);
+}
+
+void scanCandidates(const uint64_t* candidates, const int* board, int numCells, int* singles,
+                    CandidateScan& scan) {
+    getActiveKernels().scanCandidates(candidates, board, numCells, singles, scan);
+}
+
+// One pass over the board that updates the row, column and block of every cell.
+// Each unit keeps two words: digits seen at least once and digits seen at least
+// twice, so all N digits of a unit are counted (up to two) with bitwise operations.
+void findHiddenSingles(const uint64_t* candidates, int N, int blockSize, uint64_t* once, uint64_t* seen) {
+    uint64_t twice[3 * 64];
+    for (int unit = 0; unit < 3 * N; ++unit) {
+        seen[unit] = 0;
+        twice[unit] = 0;
+    }
+    uint64_t* colSeen = seen + N;
+    uint64_t* colTwice = twice + N;
+
+    for (int row = 0; row < N; ++row) {
+        const uint64_t* rowCandidates = candidates + row * N;
+        uint64_t* bandSeen = seen + 2 * N + (row / blockSize) * blockSize;
+        uint64_t* bandTwice = twice + 2 * N + (row / blockSize) * blockSize;
+        uint64_t rowSeen = 0;
+        uint64_t rowTwice = 0;
+        for (int col = 0; col < N; ++col) {
+            uint64_t mask = rowCandidates[col];
+            int block = col / blockSize;
+            rowTwice |= rowSeen & mask;
+            rowSeen |= mask;
+            colTwice[col] |= colSeen[col] & mask;
+            colSeen[col] |= mask;
+            bandTwice[block] |= bandSeen[block] & mask;
+            bandSeen[block] |= mask;
+        }
+        seen[row] = rowSeen;
+        twice[row] = rowTwice;
+    }
+
+    for (int unit = 0; unit < 3 * N; ++unit) {
+        once[unit] = seen[unit] & ~twice[unit];
+    }
+}
+
+// Reference implementation: count every digit in every unit
+void findHiddenSinglesScalar(const uint64_t* candidates, int N, int blockSize, uint64_t* once, uint64_t* seen) {
+    for (int unit = 0; unit < 3 * N; ++unit) {
+        once[unit] = 0;
+        seen[unit] = 0;
+        for (int value = 1; value <= N; ++value) {
+            int count = 0;
+            for (int i = 0; i < N; ++i) {
+                if (candidates[unitCell(N, blockSize, unit, i)] & (1ull << value)) {
+                    ++count;
+                }
+            }
+            if (count >= 1) {
+                seen[unit] |= 1ull << value;
+            }
+            if (count == 1) {
+                once[unit] |= 1ull << value;
+            }
+        }
+    }
+}
+
+const char* candidateKernelName() {
+    return getActiveKernels().name;
+}
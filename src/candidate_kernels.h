@@ -0,0 +1,89 @@
+#ifndef CANDIDATE_KERNELS_H
+#define CANDIDATE_KERNELS_H
+
+#include <cstdint>
+
+// Instruction-set level of a kernel implementation. The portable binary holds one
+// version of each kernel per level and picks the best one the CPU supports at startup.
+enum KernelPath {
+    KERNEL_SCALAR,   // Generic x86-64 (or any other architecture)
+    KERNEL_SSE42,    // SSE4.2 and POPCNT
+    KERNEL_AVX2,     // AVX2, BMI1/BMI2 (TZCNT) and POPCNT
+    KERNEL_AVX512,   // AVX-512 F/BW/VL on top of the AVX2 level
+    NUM_KERNEL_PATHS
+};
+
+// Summary of the candidate masks of one propagation pass
+struct CandidateScan {
+    int numEmpty;       // Empty cells
+    int numSingles;     // Empty cells with exactly one candidate, written to singles
+    int contradiction;  // An empty cell without candidates, -1 if none
+    int branchCell;     // First empty cell with the fewest (two or more) candidates, -1 if none
+    int fewest;         // Candidate count of branchCell
+};
+
+// Candidate masks of every cell in one pass over the board:
+//   out[row * N + col] = ~(rowMask[row] | colMask[col] | blockMask[block]) & values 1..N
+// for an empty cell and 0 for a filled cell. Bit v stands for value v, as in BitMaskState.
+// out must hold N * N entries.
+void computeAllCandidates(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                          const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out);
+
+// Portable implementation, one cell at a time
+void computeAllCandidatesScalar(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                                const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out);
+
+// Classify the empty cells of a board by candidate count (popcount of the masks of
+// computeAllCandidates). Stops at the first contradiction; the other fields are then
+// incomplete. singles must hold numCells entries.
+void scanCandidates(const uint64_t* candidates, const int* board, int numCells, int* singles,
+                    CandidateScan& scan);
+
+// Hidden-single analysis of all 3N units from the masks of computeAllCandidates.
+// Units are numbered rows 0..N-1, columns N..2N-1, blocks 2N..3N-1. For unit u:
+//   once[u] = digits with exactly one candidate cell in the unit (hidden singles)
+//   seen[u] = digits with at least one candidate cell
+// A digit missing from seen[u] that is not placed in the unit yet has nowhere to go.
+// once and seen must hold 3 * N entries.
+void findHiddenSingles(const uint64_t* candidates, int N, int blockSize, uint64_t* once, uint64_t* seen);
+
+// Reference implementation that counts the candidate cells of every digit in every
+// unit separately (O(N) per digit and unit instead of one pass over the board)
+void findHiddenSinglesScalar(const uint64_t* candidates, int N, int blockSize, uint64_t* once, uint64_t* seen);
+
+// Cell index of the i-th cell (0..N-1) of unit u, in the numbering above
+inline int unitCell(int N, int blockSize, int unit, int i) {
+    if (unit < N) {
+        return unit * N + i;
+    }
+    if (unit < 2 * N) {
+        return i * N + (unit - N);
+    }
+    int block = unit - 2 * N;
+    int row = (block / blockSize) * blockSize + i / blockSize;
+    int col = (block % blockSize) * blockSize + i % blockSize;
+    return row * N + col;
+}
+
+// The kernels of one instruction-set level
+struct KernelTable {
+    KernelPath path;
+    const char* name;  // "scalar", "sse4.2", "avx2" or "avx512"
+    void (*computeAllCandidates)(const int* board, int N, int blockSize, const uint64_t* rowMask,
+                                 const uint64_t* colMask, const uint64_t* blockMask, uint64_t* out);
+    void (*scanCandidates)(const uint64_t* candidates, const int* board, int numCells, int* singles,
+                           CandidateScan& scan);
+};
+
+// Kernels of a level, nullptr if this build or this CPU does not support it
+const KernelTable* getKernelTable(KernelPath path);
+
+// Kernels used by computeAllCandidates and scanCandidates: the best level the CPU
+// supports, or the one named by the SUDOKU_KERNEL_PATH environment variable.
+// Selected on first use.
+const KernelTable& getActiveKernels();
+
+// Name of the selected kernel path
+const char* candidateKernelName();
+
+#endif // CANDIDATE_KERNELS_H
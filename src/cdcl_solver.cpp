@@ -0,0 +1,558 @@
+#include "cdcl_solver.h"
+#include "bit_utils.h"
+#include <algorithm>
+
+CdclSolver::CdclSolver()
+    : numVars(0), ok(true), numLearnts(0), maxLearnts(0.0), propagateHead(0),
+      varIncrement(1.0), clauseIncrement(1.0), restartUnit(100) {}
+
+int CdclSolver::newVariable() {
+    int var = numVars++;
+    values.push_back(0);
+    levels.push_back(0);
+    reasons.push_back(-1);
+    activity.push_back(0.0);
+    heapIndex.push_back(-1);
+    savedPhase.push_back(false);
+    seen.push_back(0);
+    watches.resize(2 * numVars);
+    heapInsert(var);
+    return var;
+}
+
+void CdclSolver::randomizeOrder(uint64_t seed) {
+    SplitMix64 rng(seed);
+    heap.clear();
+    for (int var = 0; var < numVars; ++var) {
+        // Far below one bump, so the first conflicts take over at once
+        activity[var] = (rng.next() >> 11) * 0x1.0p-53 * 1e-3;
+        heapIndex[var] = -1;
+    }
+    for (int var = 0; var < numVars; ++var) {
+        if (values[var] == 0) {
+            heapInsert(var);
+        }
+    }
+}
+
+// Store a clause and watch its first two literals
+int CdclSolver::attachClause(const std::vector<int>& clauseLiterals, bool isLearnt) {
+    Clause clause;
+    clause.start = static_cast<int>(literals.size());
+    clause.size = static_cast<int>(clauseLiterals.size());
+    clause.learnt = isLearnt;
+    clause.deleted = false;
+    clause.activity = 0.0;
+    int index = static_cast<int>(clauses.size());
+    clauses.push_back(clause);
+    literals.insert(literals.end(), clauseLiterals.begin(), clauseLiterals.end());
+    watches[clauseLiterals[0]].push_back({index, clauseLiterals[1]});
+    watches[clauseLiterals[1]].push_back({index, clauseLiterals[0]});
+    return index;
+}
+
+bool CdclSolver::addClause(const std::vector<int>& clauseLiterals) {
+    if (!ok) {
+        return false;
+    }
+    // Drop false and repeated literals; a true literal or x / not x satisfies the clause
+    std::vector<int>& kept = learnt;
+    kept.assign(clauseLiterals.begin(), clauseLiterals.end());
+    std::sort(kept.begin(), kept.end());
+    size_t size = 0;
+    for (size_t i = 0; i < kept.size(); ++i) {
+        int literal = kept[i];
+        if (literalValue(literal) > 0 || (i > 0 && kept[i - 1] == (literal ^ 1))) {
+            return true;
+        }
+        if (literalValue(literal) < 0 || (i > 0 && kept[i - 1] == literal)) {
+            continue;
+        }
+        kept[size++] = literal;
+    }
+    kept.resize(size);
+
+    if (kept.empty()) {
+        ok = false;
+    } else if (kept.size() == 1) {
+        assign(kept[0], -1);
+        ok = (propagate() < 0);
+    } else {
+        attachClause(kept, false);
+    }
+    return ok;
+}
+
+void CdclSolver::assign(int literal, int reason) {
+    int var = literal >> 1;
+    values[var] = (literal & 1) ? -1 : 1;
+    levels[var] = decisionLevel();
+    reasons[var] = reason;
+    trail.push_back(literal);
+}
+
+// Unit propagation over the watch lists; returns a falsified clause or -1.
+// The literal a clause implies is kept at its position 0, which conflict analysis
+// relies on.
+int CdclSolver::propagate() {
+    int conflict = -1;
+    while (propagateHead < trail.size() && conflict < 0) {
+        int falseLiteral = trail[propagateHead++] ^ 1;
+        std::vector<Watcher>& watchList = watches[falseLiteral];
+        size_t keep = 0;
+        size_t next = 0;
+        while (next < watchList.size()) {
+            Watcher watcher = watchList[next++];
+            if (literalValue(watcher.blocker) > 0) {
+                watchList[keep++] = watcher;
+                continue;
+            }
+            const Clause& clause = clauses[watcher.clause];
+            if (clause.deleted) {
+                continue;
+            }
+            int* lits = &literals[clause.start];
+            if (lits[0] == falseLiteral) {
+                std::swap(lits[0], lits[1]);
+            }
+            int first = lits[0];
+            if (first != watcher.blocker && literalValue(first) > 0) {
+                watchList[keep++] = {watcher.clause, first};
+                continue;
+            }
+
+            // Look for a new literal to watch
+            bool moved = false;
+            for (int k = 2; k < clause.size; ++k) {
+                if (literalValue(lits[k]) >= 0) {
+                    std::swap(lits[1], lits[k]);
+                    watches[lits[1]].push_back({watcher.clause, first});
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+
+            watchList[keep++] = watcher;
+            if (literalValue(first) < 0) {
+                conflict = watcher.clause;
+                while (next < watchList.size()) {
+                    watchList[keep++] = watchList[next++];
+                }
+            } else {
+                assign(first, watcher.clause);
+                ++stats.propagations;
+            }
+        }
+        watchList.resize(keep);
+    }
+    return conflict;
+}
+
+// First-UIP conflict analysis. Leaves the learned clause in learnt with the
+// asserting literal first and a literal of the backjump level second.
+void CdclSolver::analyze(int conflict, int& backjumpLevel) {
+    learnt.clear();
+    learnt.push_back(-1);
+    int pathCount = 0;
+    int literal = -1;
+    int index = static_cast<int>(trail.size()) - 1;
+    int clauseIndex = conflict;
+
+    do {
+        Clause& clause = clauses[clauseIndex];
+        if (clause.learnt) {
+            bumpClause(clause);
+        }
+        const int* lits = &literals[clause.start];
+        for (int k = (literal == -1) ? 0 : 1; k < clause.size; ++k) {
+            int var = lits[k] >> 1;
+            if (!seen[var] && levels[var] > 0) {
+                seen[var] = 1;
+                bumpVariable(var);
+                if (levels[var] >= decisionLevel()) {
+                    ++pathCount;
+                } else {
+                    learnt.push_back(lits[k]);
+                }
+            }
+        }
+        // Most recent marked literal of the trail
+        while (!seen[trail[index] >> 1]) {
+            --index;
+        }
+        literal = trail[index--];
+        clauseIndex = reasons[literal >> 1];
+        seen[literal >> 1] = 0;
+        --pathCount;
+    } while (pathCount > 0);
+    learnt[0] = literal ^ 1;
+
+    // Drop literals implied by other literals of the clause
+    analyzed.assign(learnt.begin() + 1, learnt.end());
+    size_t kept = 1;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        int reason = reasons[learnt[i] >> 1];
+        bool needed = (reason < 0);
+        if (!needed) {
+            const Clause& clause = clauses[reason];
+            const int* lits = &literals[clause.start];
+            for (int k = 1; k < clause.size; ++k) {
+                int var = lits[k] >> 1;
+                if (!seen[var] && levels[var] > 0) {
+                    needed = true;
+                    break;
+                }
+            }
+        }
+        if (needed) {
+            learnt[kept++] = learnt[i];
+        }
+    }
+    learnt.resize(kept);
+    for (int analyzedLiteral : analyzed) {
+        seen[analyzedLiteral >> 1] = 0;
+    }
+
+    // Backjump to the highest level below the conflict
+    backjumpLevel = 0;
+    if (learnt.size() > 1) {
+        size_t highest = 1;
+        for (size_t i = 2; i < learnt.size(); ++i) {
+            if (levels[learnt[i] >> 1] > levels[learnt[highest] >> 1]) {
+                highest = i;
+            }
+        }
+        std::swap(learnt[1], learnt[highest]);
+        backjumpLevel = levels[learnt[1] >> 1];
+    }
+}
+
+// Undo all assignments above a decision level
+void CdclSolver::cancelUntil(int level) {
+    if (decisionLevel() <= level) {
+        return;
+    }
+    for (int i = static_cast<int>(trail.size()) - 1; i >= trailLimits[level]; --i) {
+        int var = trail[i] >> 1;
+        savedPhase[var] = values[var] > 0;
+        values[var] = 0;
+        reasons[var] = -1;
+        heapInsert(var);
+    }
+    trail.resize(trailLimits[level]);
+    trailLimits.resize(level);
+    propagateHead = trail.size();
+}
+
+// Delete the less active half of the learned clauses that are not the reason of
+// a current assignment. Binary clauses are kept. Their watchers are dropped
+// lazily by propagate.
+void CdclSolver::reduceLearnts() {
+    std::vector<int> candidates;
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        const Clause& clause = clauses[i];
+        if (!clause.learnt || clause.deleted || clause.size <= 2) {
+            continue;
+        }
+        int var = literals[clause.start] >> 1;
+        bool locked = values[var] != 0 && reasons[var] == static_cast<int>(i);
+        if (!locked) {
+            candidates.push_back(static_cast<int>(i));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+        return clauses[a].activity < clauses[b].activity;
+    });
+    for (size_t i = 0; i < candidates.size() / 2; ++i) {
+        clauses[candidates[i]].deleted = true;
+        --numLearnts;
+        ++stats.deletedClauses;
+    }
+}
+
+int CdclSolver::pickBranchLiteral() {
+    while (!heap.empty()) {
+        int var = heapRemoveMax();
+        if (values[var] == 0) {
+            return savedPhase[var] ? positive(var) : negative(var);
+        }
+    }
+    return -1;
+}
+
+CdclResult CdclSolver::solve(long long conflictBudget) {
+    model.clear();
+    if (!ok || propagate() >= 0) {
+        ok = false;
+        return CDCL_UNSATISFIABLE;
+    }
+    if (maxLearnts == 0.0) {
+        maxLearnts = std::max(2000.0, clauses.size() / 3.0);
+    }
+
+    const long long conflictsAtStart = stats.conflicts;
+    int restartIndex = 0;
+    long long restartLimit = lubyTerm(restartIndex) * restartUnit;
+    long long conflictsSinceRestart = 0;
+
+    while (true) {
+        int conflict = propagate();
+        if (conflict >= 0) {
+            ++stats.conflicts;
+            ++conflictsSinceRestart;
+            if (decisionLevel() == 0) {
+                ok = false;
+                return CDCL_UNSATISFIABLE;
+            }
+            int backjumpLevel;
+            analyze(conflict, backjumpLevel);
+            stats.backjumpLevels += decisionLevel() - backjumpLevel;
+            cancelUntil(backjumpLevel);
+            ++stats.learnedClauses;
+            if (learnt.size() == 1) {
+                assign(learnt[0], -1);
+            } else {
+                int clause = attachClause(learnt, true);
+                ++numLearnts;
+                bumpClause(clauses[clause]);
+                assign(learnt[0], clause);
+            }
+            varIncrement /= 0.95;
+            clauseIncrement /= 0.999;
+
+            if (conflictBudget >= 0 && stats.conflicts - conflictsAtStart >= conflictBudget) {
+                cancelUntil(0);
+                return CDCL_UNKNOWN;
+            }
+            continue;
+        }
+
+        if (conflictsSinceRestart >= restartLimit) {
+            ++stats.restarts;
+            cancelUntil(0);
+            conflictsSinceRestart = 0;
+            restartLimit = lubyTerm(++restartIndex) * restartUnit;
+        }
+        if (numLearnts - static_cast<double>(trail.size()) >= maxLearnts) {
+            reduceLearnts();
+            maxLearnts *= 1.1;
+        }
+
+        int literal = pickBranchLiteral();
+        if (literal < 0) {
+            model = values;
+            cancelUntil(0);
+            return CDCL_SATISFIABLE;
+        }
+        ++stats.decisions;
+        trailLimits.push_back(static_cast<int>(trail.size()));
+        assign(literal, -1);
+    }
+}
+
+void CdclSolver::bumpVariable(int var) {
+    activity[var] += varIncrement;
+    if (activity[var] > 1e100) {
+        for (double& score : activity) {
+            score *= 1e-100;
+        }
+        varIncrement *= 1e-100;
+    }
+    if (heapIndex[var] >= 0) {
+        heapUp(heapIndex[var]);
+    }
+}
+
+void CdclSolver::bumpClause(Clause& clause) {
+    clause.activity += clauseIncrement;
+    if (clause.activity > 1e20) {
+        for (Clause& other : clauses) {
+            if (other.learnt) {
+                other.activity *= 1e-20;
+            }
+        }
+        clauseIncrement *= 1e-20;
+    }
+}
+
+void CdclSolver::heapInsert(int var) {
+    if (heapIndex[var] >= 0) {
+        return;
+    }
+    heapIndex[var] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    heapUp(heapIndex[var]);
+}
+
+int CdclSolver::heapRemoveMax() {
+    int top = heap[0];
+    heapIndex[top] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap[0] = last;
+        heapIndex[last] = 0;
+        heapDown(0);
+    }
+    return top;
+}
+
+void CdclSolver::heapUp(int position) {
+    int var = heap[position];
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+        if (activity[heap[parent]] >= activity[var]) {
+            break;
+        }
+        heap[position] = heap[parent];
+        heapIndex[heap[position]] = position;
+        position = parent;
+    }
+    heap[position] = var;
+    heapIndex[var] = position;
+}
+
+void CdclSolver::heapDown(int position) {
+    int var = heap[position];
+    int size = static_cast<int>(heap.size());
+    while (2 * position + 1 < size) {
+        int child = 2 * position + 1;
+        if (child + 1 < size && activity[heap[child + 1]] > activity[heap[child]]) {
+            ++child;
+        }
+        if (activity[heap[child]] <= activity[var]) {
+            break;
+        }
+        heap[position] = heap[child];
+        heapIndex[heap[position]] = position;
+        position = child;
+    }
+    heap[position] = var;
+    heapIndex[var] = position;
+}
+
+// Pairwise at-most-one clauses over vars; skip(i, j) leaves out pairs another
+// constraint already covers
+template <typename SkipFn>
+static bool addAtMostOne(CdclSolver& solver, const std::vector<int>& vars, SkipFn skip) {
+    std::vector<int> pair(2);
+    for (size_t i = 0; i < vars.size(); ++i) {
+        for (size_t j = i + 1; j < vars.size(); ++j) {
+            if (skip(i, j)) {
+                continue;
+            }
+            pair[0] = CdclSolver::negative(vars[i]);
+            pair[1] = CdclSolver::negative(vars[j]);
+            if (!solver.addClause(pair)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool encodeSudoku(const int* board, int N, int blockSize, CdclSolver& solver, SudokuCnf& cnf) {
+    cnf.N = N;
+    cnf.varOf.assign(N * N * (N + 1), -1);
+    cnf.cellOf.clear();
+    cnf.valueOf.clear();
+
+    std::vector<uint64_t> rowUsed(N, 0), colUsed(N, 0), blockUsed(N, 0);
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (board[cell] != 0) {
+            int row = cell / N;
+            int col = cell % N;
+            rowUsed[row] |= 1ull << board[cell];
+            colUsed[col] |= 1ull << board[cell];
+            blockUsed[(row / blockSize) * blockSize + col / blockSize] |= 1ull << board[cell];
+        }
+    }
+
+    // One variable per candidate of an empty cell
+    const uint64_t fullMask = ((N >= 63) ? ~0ull : ((1ull << (N + 1)) - 1)) & ~1ull;
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (board[cell] != 0) {
+            continue;
+        }
+        int row = cell / N;
+        int col = cell % N;
+        uint64_t mask = fullMask & ~(rowUsed[row] | colUsed[col] | blockUsed[(row / blockSize) * blockSize + col / blockSize]);
+        for (; mask != 0; mask &= mask - 1) {
+            int value = lowestBit64(mask);
+            int var = solver.newVariable();
+            cnf.varOf[cell * (N + 1) + value] = var;
+            cnf.cellOf.push_back(cell);
+            cnf.valueOf.push_back(value);
+        }
+    }
+
+    // Every empty cell takes exactly one value
+    std::vector<int> vars, clause;
+    auto never = [](size_t, size_t) { return false; };
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (board[cell] != 0) {
+            continue;
+        }
+        vars.clear();
+        for (int value = 1; value <= N; ++value) {
+            if (cnf.varOf[cell * (N + 1) + value] >= 0) {
+                vars.push_back(cnf.varOf[cell * (N + 1) + value]);
+            }
+        }
+        clause.clear();
+        for (int var : vars) {
+            clause.push_back(CdclSolver::positive(var));
+        }
+        if (!solver.addClause(clause) || !addAtMostOne(solver, vars, never)) {
+            return false;
+        }
+    }
+
+    // Every value missing from a unit takes exactly one of its cells. Within a
+    // block, pairs in one row or column are already excluded by that unit.
+    std::vector<int> cells;
+    for (int unit = 0; unit < 3 * N; ++unit) {
+        int index = unit % N;
+        uint64_t used = (unit < N) ? rowUsed[index] : (unit < 2 * N) ? colUsed[index] : blockUsed[index];
+        for (int value = 1; value <= N; ++value) {
+            if (used & (1ull << value)) {
+                continue;
+            }
+            vars.clear();
+            cells.clear();
+            for (int i = 0; i < N; ++i) {
+                int cell;
+                if (unit < N) {
+                    cell = index * N + i;
+                } else if (unit < 2 * N) {
+                    cell = i * N + index;
+                } else {
+                    cell = ((index / blockSize) * blockSize + i / blockSize) * N
+                         + (index % blockSize) * blockSize + i % blockSize;
+                }
+                if (cnf.varOf[cell * (N + 1) + value] >= 0) {
+                    vars.push_back(cnf.varOf[cell * (N + 1) + value]);
+                    cells.push_back(cell);
+                }
+            }
+            clause.clear();
+            for (int var : vars) {
+                clause.push_back(CdclSolver::positive(var));
+            }
+            if (!solver.addClause(clause)) {
+                return false;
+            }
+            bool isBlock = unit >= 2 * N;
+            auto sharedLine = [&](size_t i, size_t j) {
+                return isBlock && (cells[i] / N == cells[j] / N || cells[i] % N == cells[j] % N);
+            };
+            if (!addAtMostOne(solver, vars, sharedLine)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
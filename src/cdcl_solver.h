@@ -0,0 +1,145 @@
+#ifndef CDCL_SOLVER_H
+#define CDCL_SOLVER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Outcome of CdclSolver::solve
+enum CdclResult {
+    CDCL_SATISFIABLE,
+    CDCL_UNSATISFIABLE,
+    CDCL_UNKNOWN         // Conflict budget exhausted
+};
+
+// Search counters of a CdclSolver
+struct CdclStats {
+    long long decisions;     // Branching literals chosen
+    long long propagations;  // Literals implied by unit propagation
+    long long conflicts;     // Clauses falsified during search
+    long long backjumpLevels;  // Decision levels undone by conflict analysis
+    long long learnedClauses;  // Clauses learned (units included)
+    long long deletedClauses;  // Learned clauses dropped by database reduction
+    long long restarts;
+
+    CdclStats()
+        : decisions(0), propagations(0), conflicts(0), backjumpLevels(0),
+          learnedClauses(0), deletedClauses(0), restarts(0) {}
+};
+
+// Conflict-driven clause learning SAT solver: two watched literals per clause,
+// first-UIP learning with clause minimization, non-chronological backjumping,
+// VSIDS branching with phase saving, Luby restarts and activity-based deletion
+// of learned clauses. Literals are 2 * var for the positive and 2 * var + 1 for
+// the negative literal. Clauses may be added between solve calls (for example
+// to block a found model); learned clauses are kept.
+class CdclSolver {
+public:
+    CdclSolver();
+
+    static int positive(int var) { return 2 * var; }
+    static int negative(int var) { return 2 * var + 1; }
+
+    // Add a variable and return its index
+    int newVariable();
+    int numVariables() const { return numVars; }
+
+    // Add a clause at decision level 0. Returns false once the clauses are unsatisfiable.
+    bool addClause(const std::vector<int>& literals);
+
+    // Search for a model; conflictBudget < 0 means no limit
+    CdclResult solve(long long conflictBudget = -1);
+
+    // Value of a variable in the model of the last satisfiable solve
+    bool modelValue(int var) const { return model[var] > 0; }
+
+    // Replace the initial (index) branching order by a random one
+    void randomizeOrder(uint64_t seed);
+
+    // Conflicts between restarts are restartUnit times the Luby sequence (1 1 2 1 1 2 4 ...)
+    void setRestartUnit(int conflicts) { restartUnit = conflicts; }
+
+    const CdclStats& getStats() const { return stats; }
+
+private:
+    struct Clause {
+        int start;       // Offset of the first literal in literals
+        int size;
+        bool learnt;
+        bool deleted;
+        double activity;
+    };
+    // A clause watching a literal; blocker is another literal of the clause whose
+    // truth means the clause need not be visited
+    struct Watcher {
+        int clause;
+        int blocker;
+    };
+
+    int numVars;
+    bool ok;                              // False once a conflict at level 0 was found
+    std::vector<int> literals;            // Literals of all clauses, back to back
+    std::vector<Clause> clauses;
+    std::vector<std::vector<Watcher>> watches;  // Per literal: clauses watching it
+    int numLearnts;
+    double maxLearnts;
+
+    std::vector<int8_t> values;           // Per variable: 1 true, -1 false, 0 unassigned
+    std::vector<int> levels;              // Decision level of each assigned variable
+    std::vector<int> reasons;             // Implying clause, -1 for decisions and level 0 units
+    std::vector<int> trail;               // Assigned literals in assignment order
+    std::vector<int> trailLimits;         // Trail size at the start of each decision level
+    size_t propagateHead;                 // Next trail entry to propagate
+
+    std::vector<double> activity;         // VSIDS score per variable
+    double varIncrement;
+    double clauseIncrement;
+    std::vector<int> heap;                // Max-heap of variables by activity
+    std::vector<int> heapIndex;           // Position in heap, -1 if absent
+    std::vector<bool> savedPhase;         // Last value of each variable (true = positive)
+
+    std::vector<char> seen;               // Scratch marks of conflict analysis
+    std::vector<int> learnt;              // Scratch learned clause
+    std::vector<int> analyzed;            // Scratch: literals whose seen mark must be cleared
+    std::vector<int8_t> model;
+    int restartUnit;
+    CdclStats stats;
+
+    int8_t literalValue(int literal) const {
+        int8_t value = values[literal >> 1];
+        return (literal & 1) ? static_cast<int8_t>(-value) : value;
+    }
+    int decisionLevel() const { return static_cast<int>(trailLimits.size()); }
+
+    int attachClause(const std::vector<int>& clauseLiterals, bool isLearnt);
+    void assign(int literal, int reason);
+    int propagate();
+    void analyze(int conflict, int& backjumpLevel);
+    void cancelUntil(int level);
+    void reduceLearnts();
+    int pickBranchLiteral();
+
+    void bumpVariable(int var);
+    void bumpClause(Clause& clause);
+    void heapInsert(int var);
+    int heapRemoveMax();
+    void heapUp(int position);
+    void heapDown(int position);
+};
+
+// Mapping between Sudoku placements and CNF variables: one variable per
+// (empty cell, candidate value)
+struct SudokuCnf {
+    int N;
+    std::vector<int> varOf;   // [cell * (N + 1) + value] -> variable, -1 if not a candidate
+    std::vector<int> cellOf;  // Per variable
+    std::vector<int> valueOf; // Per variable
+};
+
+// Encode the empty cells of a partially filled board: every cell takes exactly one
+// candidate, and every value missing from a row, column or block takes exactly one
+// cell of it (pairwise at-most-one clauses). Returns false if the clauses are
+// already unsatisfiable (a cell or unit without candidates).
+bool encodeSudoku(const int* board, int N, int blockSize, CdclSolver& solver, SudokuCnf& cnf);
+
+#endif // CDCL_SOLVER_H
@@ -0,0 +1,150 @@
+#include "checkpoint.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// File layout (one record per line):
+//   sudoku-checkpoint 1
+//   N <N> depth <partitionDepth> subproblems <count> total <totalSolutions>
+//   board <N*N values>
+//   done <id> <solutions>                  (one per completed subproblem)
+//   pending <id> <startPos> <N*N values>   (one per remaining subproblem)
+//   end
+static const char* CHECKPOINT_MAGIC = "sudoku-checkpoint";
+static const int CHECKPOINT_VERSION = 1;
+
+// Flush a written file to disk before it replaces the old checkpoint
+static void syncFile(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+bool writeCheckpoint(const std::string& path, const Checkpoint& checkpoint) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not create checkpoint " << temporary << std::endl;
+            return false;
+        }
+        file << CHECKPOINT_MAGIC << " " << CHECKPOINT_VERSION << "\n";
+        file << "N " << checkpoint.N << " depth " << checkpoint.partitionDepth
+             << " subproblems " << checkpoint.numSubproblems
+             << " total " << checkpoint.totalSolutions << "\n";
+        file << "board";
+        for (int value : checkpoint.board) {
+            file << " " << value;
+        }
+        file << "\n";
+        for (size_t i = 0; i < checkpoint.completedIds.size(); ++i) {
+            file << "done " << checkpoint.completedIds[i] << " " << checkpoint.completedCounts[i] << "\n";
+        }
+        for (const PendingSubproblem& subproblem : checkpoint.pending) {
+            file << "pending " << subproblem.id << " " << subproblem.startPos;
+            for (int value : subproblem.board) {
+                file << " " << value;
+            }
+            file << "\n";
+        }
+        file << "end\n";
+        file.flush();
+        if (!file) {
+            std::cerr << "Error: Could not write checkpoint " << temporary << std::endl;
+            return false;
+        }
+    }
+    syncFile(temporary);
+    // rename replaces the old file atomically on POSIX systems
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not replace checkpoint " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool readCheckpoint(const std::string& path, Checkpoint& checkpoint) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open checkpoint " << path << std::endl;
+        return false;
+    }
+
+    std::string word;
+    int version = 0;
+    if (!(file >> word >> version) || word != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION) {
+        std::cerr << "Error: " << path << " is not a version " << CHECKPOINT_VERSION << " checkpoint" << std::endl;
+        return false;
+    }
+    std::string nKey, depthKey, countKey, totalKey;
+    file >> nKey >> checkpoint.N >> depthKey >> checkpoint.partitionDepth
+         >> countKey >> checkpoint.numSubproblems >> totalKey >> checkpoint.totalSolutions;
+    if (!file || nKey != "N" || depthKey != "depth" || countKey != "subproblems" || totalKey != "total" ||
+        checkpoint.N <= 0 || checkpoint.N > 64) {
+        std::cerr << "Error: Malformed checkpoint header in " << path << std::endl;
+        return false;
+    }
+    const int cells = checkpoint.N * checkpoint.N;
+
+    checkpoint.board.assign(cells, 0);
+    file >> word;
+    for (int i = 0; i < cells && word == "board"; ++i) {
+        file >> checkpoint.board[i];
+    }
+    if (!file || word != "board") {
+        std::cerr << "Error: Malformed board in checkpoint " << path << std::endl;
+        return false;
+    }
+
+    checkpoint.completedIds.clear();
+    checkpoint.completedCounts.clear();
+    checkpoint.pending.clear();
+    long long completedTotal = 0;
+    bool ended = false;
+    while (file >> word) {
+        if (word == "done") {
+            int id = 0;
+            long long count = 0;
+            file >> id >> count;
+            checkpoint.completedIds.push_back(id);
+            checkpoint.completedCounts.push_back(count);
+            completedTotal += count;
+        } else if (word == "pending") {
+            PendingSubproblem subproblem;
+            subproblem.board.assign(cells, 0);
+            file >> subproblem.id >> subproblem.startPos;
+            for (int i = 0; i < cells; ++i) {
+                file >> subproblem.board[i];
+            }
+            checkpoint.pending.push_back(subproblem);
+        } else if (word == "end") {
+            ended = true;
+            break;
+        } else {
+            break;
+        }
+        if (!file) {
+            break;
+        }
+    }
+
+    // A truncated file or inconsistent counts must not be resumed silently
+    size_t accounted = checkpoint.completedIds.size() + checkpoint.pending.size();
+    if (!ended || completedTotal != checkpoint.totalSolutions ||
+        accounted != static_cast<size_t>(checkpoint.numSubproblems)) {
+        std::cerr << "Error: Checkpoint " << path << " is incomplete or inconsistent" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <vector>
+#include <string>
+
+// A frontier subproblem that had not finished when the checkpoint was written
+struct PendingSubproblem {
+    int id;                  // Index in the original frontier
+    int startPos;
+    std::vector<int> board;
+};
+
+// State of a solveParallelOptimized run: what is done, and what is left
+struct Checkpoint {
+    int N;
+    std::vector<int> board;            // Puzzle being counted
+    int partitionDepth;
+    int numSubproblems;                // Size of the original frontier
+    long long totalSolutions;          // Sum of the completed counts
+    std::vector<int> completedIds;     // Finished subproblems ...
+    std::vector<long long> completedCounts;  // ... and their solution counts
+    std::vector<PendingSubproblem> pending;
+};
+
+// Write a checkpoint as text. The file is written under a temporary name and renamed
+// over path, so a crash while writing leaves the previous checkpoint intact.
+bool writeCheckpoint(const std::string& path, const Checkpoint& checkpoint);
+
+// Read a checkpoint written by writeCheckpoint. Returns false (with a message) if the
+// file cannot be opened or is malformed, including a total that does not match the
+// completed counts.
+bool readCheckpoint(const std::string& path, Checkpoint& checkpoint);
+
+#endif // CHECKPOINT_H
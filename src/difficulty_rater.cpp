@@ -0,0 +1,553 @@
+#include "difficulty_rater.h"
+#include "bit_utils.h"
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <map>
+#include <algorithm>
+#include <omp.h>
+
+// Human-readable technique name
+const char* techniqueName(Technique technique) {
+    switch (technique) {
+        case Technique::None:             return "None";
+        case Technique::NakedSingle:      return "NakedSingle";
+        case Technique::HiddenSingle:     return "HiddenSingle";
+        case Technique::LockedCandidates: return "LockedCandidates";
+        case Technique::NakedSubset:      return "NakedSubset";
+        case Technique::HiddenSubset:     return "HiddenSubset";
+        case Technique::Search:           return "Search";
+    }
+    return "Unknown";
+}
+
+// Constructor: precompute units and peers
+DifficultyRater::DifficultyRater(int N) : N(N), maxSubsetSize(4), nodeLimit(1000000) {
+    blockSize = static_cast<int>(sqrt(N));
+
+    // Validate that N is a perfect square
+    if (blockSize * blockSize != N) {
+        std::cerr << "Warning: N=" << N << " is not a perfect square. "
+                  << "Sudoku constraints may not work correctly." << std::endl;
+    }
+
+    fullMask = ((1ull << (N + 1)) - 1) & ~1ull;
+
+    // Units: rows, then columns, then blocks
+    unitCells.resize(3 * N * N);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            unitCells[i * N + j] = i * N + j;
+            unitCells[(N + i) * N + j] = j * N + i;
+            int row = (i / blockSize) * blockSize + j / blockSize;
+            int col = (i % blockSize) * blockSize + j % blockSize;
+            unitCells[(2 * N + i) * N + j] = row * N + col;
+        }
+    }
+
+    // Peers: cells sharing a row, column or block
+    peerCount = 2 * (N - 1) + (blockSize - 1) * (blockSize - 1);
+    peerCells.reserve(N * N * peerCount);
+    for (int cell = 0; cell < N * N; ++cell) {
+        int row = cell / N;
+        int col = cell % N;
+        for (int other = 0; other < N * N; ++other) {
+            int otherRow = other / N;
+            int otherCol = other % N;
+            bool sameBlock = (row / blockSize == otherRow / blockSize) &&
+                             (col / blockSize == otherCol / blockSize);
+            if (other != cell && (row == otherRow || col == otherCol || sameBlock)) {
+                peerCells.push_back(other);
+            }
+        }
+    }
+}
+
+// Build the working grid from a board; returns false if the givens conflict
+bool DifficultyRater::initGrid(const std::vector<int>& board, Grid& grid) const {
+    grid.values.assign(N * N, 0);
+    grid.candidates.assign(N * N, fullMask);
+    grid.numFilled = 0;
+
+    for (int cell = 0; cell < N * N; ++cell) {
+        int value = board[cell];
+        if (value == 0) {
+            continue;
+        }
+        if (value < 1 || value > N || !(grid.candidates[cell] & (1ull << value))) {
+            return false;
+        }
+        place(grid, cell, value);
+    }
+    return true;
+}
+
+// Place a value and remove it from the candidates of all peers
+void DifficultyRater::place(Grid& grid, int cell, int value) const {
+    uint64_t bit = 1ull << value;
+    grid.values[cell] = value;
+    grid.candidates[cell] = 0;
+    ++grid.numFilled;
+
+    const int* peers = &peerCells[cell * peerCount];
+    for (int i = 0; i < peerCount; ++i) {
+        grid.candidates[peers[i]] &= ~bit;
+    }
+}
+
+// Naked singles: cells left with exactly one candidate
+int DifficultyRater::applyNakedSingles(Grid& grid) const {
+    int placed = 0;
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (grid.values[cell] != 0) {
+            continue;
+        }
+        uint64_t mask = grid.candidates[cell];
+        if (mask == 0) {
+            return -1;
+        }
+        if ((mask & (mask - 1)) == 0) {
+            place(grid, cell, lowestBit64(mask));
+            ++placed;
+        }
+    }
+    return placed;
+}
+
+// Hidden singles: values with exactly one possible cell in a unit
+int DifficultyRater::applyHiddenSingles(Grid& grid) const {
+    int placed = 0;
+    for (int unit = 0; unit < 3 * N; ++unit) {
+        const int* cells = &unitCells[unit * N];
+
+        uint64_t seenOnce = 0;
+        uint64_t seenTwice = 0;
+        uint64_t used = 0;
+        for (int i = 0; i < N; ++i) {
+            int cell = cells[i];
+            if (grid.values[cell] != 0) {
+                used |= 1ull << grid.values[cell];
+            } else {
+                seenTwice |= seenOnce & grid.candidates[cell];
+                seenOnce |= grid.candidates[cell];
+            }
+        }
+
+        // A value that fits nowhere in the unit is a contradiction
+        if (fullMask & ~(used | seenOnce)) {
+            return -1;
+        }
+
+        uint64_t hidden = seenOnce & ~seenTwice;
+        while (hidden != 0) {
+            int value = lowestBit64(hidden);
+            hidden &= hidden - 1;
+
+            int target = -1;
+            for (int i = 0; i < N; ++i) {
+                if (grid.values[cells[i]] == 0 && (grid.candidates[cells[i]] & (1ull << value))) {
+                    target = cells[i];
+                    break;
+                }
+            }
+            if (target < 0) {
+                return -1;  // The only cell for this value was taken by another hidden single
+            }
+            place(grid, target, value);
+            ++placed;
+        }
+    }
+    return placed;
+}
+
+// Locked candidates: pointing (block -> line) and claiming (line -> block)
+int DifficultyRater::applyLockedCandidates(Grid& grid) const {
+    int eliminated = 0;
+    std::vector<uint64_t> lineUnion(blockSize);
+
+    // Pointing: a value confined to one row (or column) of a block is removed from
+    // the rest of that row (or column)
+    for (int block = 0; block < N; ++block) {
+        int blockRow = (block / blockSize) * blockSize;
+        int blockCol = (block % blockSize) * blockSize;
+
+        for (int byColumn = 0; byColumn < 2; ++byColumn) {
+            std::fill(lineUnion.begin(), lineUnion.end(), 0);
+            uint64_t blockUnion = 0;
+            for (int i = 0; i < blockSize; ++i) {
+                for (int j = 0; j < blockSize; ++j) {
+                    int cell = (blockRow + i) * N + blockCol + j;
+                    lineUnion[byColumn ? j : i] |= grid.candidates[cell];
+                    blockUnion |= grid.candidates[cell];
+                }
+            }
+
+            while (blockUnion != 0) {
+                uint64_t bit = blockUnion & (~blockUnion + 1);
+                blockUnion &= blockUnion - 1;
+
+                int line = -1;
+                int lines = 0;
+                for (int k = 0; k < blockSize; ++k) {
+                    if (lineUnion[k] & bit) {
+                        line = k;
+                        ++lines;
+                    }
+                }
+                if (lines != 1) {
+                    continue;
+                }
+
+                for (int k = 0; k < N; ++k) {
+                    int cell = byColumn ? k * N + blockCol + line : (blockRow + line) * N + k;
+                    int inBlock = byColumn ? (k / blockSize == blockRow / blockSize)
+                                           : (k / blockSize == blockCol / blockSize);
+                    if (!inBlock && (grid.candidates[cell] & bit)) {
+                        grid.candidates[cell] &= ~bit;
+                        ++eliminated;
+                    }
+                }
+            }
+        }
+    }
+
+    if (eliminated > 0) {
+        return eliminated;
+    }
+
+    // Claiming: a value confined to one block within a row (or column) is removed
+    // from the rest of that block
+    for (int unit = 0; unit < 2 * N; ++unit) {
+        const int* cells = &unitCells[unit * N];
+        std::fill(lineUnion.begin(), lineUnion.end(), 0);
+        uint64_t unitUnion = 0;
+        for (int i = 0; i < N; ++i) {
+            lineUnion[i / blockSize] |= grid.candidates[cells[i]];
+            unitUnion |= grid.candidates[cells[i]];
+        }
+
+        while (unitUnion != 0) {
+            uint64_t bit = unitUnion & (~unitUnion + 1);
+            unitUnion &= unitUnion - 1;
+
+            int segment = -1;
+            int segments = 0;
+            for (int k = 0; k < blockSize; ++k) {
+                if (lineUnion[k] & bit) {
+                    segment = k;
+                    ++segments;
+                }
+            }
+            if (segments != 1) {
+                continue;
+            }
+
+            // Block containing the segment, and the line index inside it
+            int firstCell = cells[segment * blockSize];
+            int row = firstCell / N;
+            int col = firstCell % N;
+            int blockRow = (row / blockSize) * blockSize;
+            int blockCol = (col / blockSize) * blockSize;
+            for (int i = 0; i < blockSize; ++i) {
+                for (int j = 0; j < blockSize; ++j) {
+                    int r = blockRow + i;
+                    int c = blockCol + j;
+                    bool onLine = (unit < N) ? (r == row) : (c == col);
+                    int cell = r * N + c;
+                    if (!onLine && (grid.candidates[cell] & bit)) {
+                        grid.candidates[cell] &= ~bit;
+                        ++eliminated;
+                    }
+                }
+            }
+        }
+    }
+
+    return eliminated;
+}
+
+// Recursively look for size cells of a unit whose candidates union has size values
+int DifficultyRater::findNakedSubset(Grid& grid, const int* cells, const std::vector<int>& pool, int start,
+                                     int size, int chosen, uint64_t unionMask, uint64_t chosenCells) const {
+    if (popcount64(unionMask) > size) {
+        return 0;
+    }
+    if (chosen == size) {
+        int eliminated = 0;
+        for (int i = 0; i < N; ++i) {
+            int cell = cells[i];
+            if (grid.values[cell] == 0 && !(chosenCells & (1ull << i)) && (grid.candidates[cell] & unionMask)) {
+                eliminated += popcount64(grid.candidates[cell] & unionMask);
+                grid.candidates[cell] &= ~unionMask;
+            }
+        }
+        return eliminated;
+    }
+
+    for (int k = start; k < static_cast<int>(pool.size()); ++k) {
+        int i = pool[k];
+        int eliminated = findNakedSubset(grid, cells, pool, k + 1, size, chosen + 1,
+                                         unionMask | grid.candidates[cells[i]], chosenCells | (1ull << i));
+        if (eliminated != 0) {
+            return eliminated;
+        }
+    }
+    return 0;
+}
+
+// Naked subsets: k cells of a unit holding exactly k candidates between them
+int DifficultyRater::applyNakedSubsets(Grid& grid) const {
+    std::vector<int> pool;
+    for (int size = 2; size <= maxSubsetSize; ++size) {
+        for (int unit = 0; unit < 3 * N; ++unit) {
+            const int* cells = &unitCells[unit * N];
+            pool.clear();
+            int numEmpty = 0;
+            for (int i = 0; i < N; ++i) {
+                if (grid.values[cells[i]] != 0) {
+                    continue;
+                }
+                ++numEmpty;
+                int count = popcount64(grid.candidates[cells[i]]);
+                if (count >= 2 && count <= size) {
+                    pool.push_back(i);
+                }
+            }
+            if (numEmpty <= size || static_cast<int>(pool.size()) < size) {
+                continue;
+            }
+
+            int eliminated = findNakedSubset(grid, cells, pool, 0, size, 0, 0, 0);
+            if (eliminated != 0) {
+                return eliminated;
+            }
+        }
+    }
+    return 0;
+}
+
+// Recursively look for size values of a unit confined to size cells
+int DifficultyRater::findHiddenSubset(Grid& grid, const int* cells, const std::vector<uint64_t>& positions,
+                                      const std::vector<int>& pool, int start, int size, int chosen,
+                                      uint64_t valueMask, uint64_t unionPositions) const {
+    if (popcount64(unionPositions) > size) {
+        return 0;
+    }
+    if (chosen == size) {
+        int eliminated = 0;
+        for (int i = 0; i < N; ++i) {
+            int cell = cells[i];
+            if ((unionPositions & (1ull << i)) && (grid.candidates[cell] & ~valueMask)) {
+                eliminated += popcount64(grid.candidates[cell] & ~valueMask);
+                grid.candidates[cell] &= valueMask;
+            }
+        }
+        return eliminated;
+    }
+
+    for (int k = start; k < static_cast<int>(pool.size()); ++k) {
+        int value = pool[k];
+        int eliminated = findHiddenSubset(grid, cells, positions, pool, k + 1, size, chosen + 1,
+                                          valueMask | (1ull << value), unionPositions | positions[value]);
+        if (eliminated != 0) {
+            return eliminated;
+        }
+    }
+    return 0;
+}
+
+// Hidden subsets: k values of a unit that can only go in the same k cells
+int DifficultyRater::applyHiddenSubsets(Grid& grid) const {
+    std::vector<uint64_t> positions(N + 1);
+    std::vector<int> pool;
+    for (int size = 2; size <= maxSubsetSize; ++size) {
+        for (int unit = 0; unit < 3 * N; ++unit) {
+            const int* cells = &unitCells[unit * N];
+            std::fill(positions.begin(), positions.end(), 0);
+            int numEmpty = 0;
+            for (int i = 0; i < N; ++i) {
+                if (grid.values[cells[i]] != 0) {
+                    continue;
+                }
+                ++numEmpty;
+                uint64_t mask = grid.candidates[cells[i]];
+                while (mask != 0) {
+                    positions[lowestBit64(mask)] |= 1ull << i;
+                    mask &= mask - 1;
+                }
+            }
+            if (numEmpty <= size) {
+                continue;
+            }
+
+            pool.clear();
+            for (int value = 1; value <= N; ++value) {
+                int count = popcount64(positions[value]);
+                if (count >= 2 && count <= size) {
+                    pool.push_back(value);
+                }
+            }
+            if (static_cast<int>(pool.size()) < size) {
+                continue;
+            }
+
+            int eliminated = findHiddenSubset(grid, cells, positions, pool, 0, size, 0, 0, 0);
+            if (eliminated != 0) {
+                return eliminated;
+            }
+        }
+    }
+    return 0;
+}
+
+// Apply techniques in increasing order, restarting from the easiest after each step
+int DifficultyRater::propagate(Grid& grid, Technique maxLevel, DifficultyRating* rating) const {
+    while (grid.numFilled < N * N) {
+        int result = 0;
+        int level = static_cast<int>(Technique::NakedSingle);
+        for (; level <= static_cast<int>(maxLevel); ++level) {
+            switch (static_cast<Technique>(level)) {
+                case Technique::NakedSingle:      result = applyNakedSingles(grid); break;
+                case Technique::HiddenSingle:     result = applyHiddenSingles(grid); break;
+                case Technique::LockedCandidates: result = applyLockedCandidates(grid); break;
+                case Technique::NakedSubset:      result = applyNakedSubsets(grid); break;
+                case Technique::HiddenSubset:     result = applyHiddenSubsets(grid); break;
+                default:                          result = 0; break;
+            }
+            if (result != 0) {
+                break;
+            }
+        }
+
+        if (result < 0) {
+            return -1;
+        }
+        if (result == 0) {
+            return 0;  // Stuck at this technique level
+        }
+        if (rating != nullptr) {
+            rating->techniqueUses[level] += result;
+            rating->hardest = std::max(rating->hardest, static_cast<Technique>(level));
+        }
+    }
+    return 1;
+}
+
+// Backtracking search with singles propagation, stops after two solutions
+void DifficultyRater::search(Grid& grid, DifficultyRating& rating) const {
+    // Branch on the empty cell with the fewest candidates
+    int bestCell = -1;
+    int bestCount = N + 1;
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (grid.values[cell] == 0) {
+            int count = popcount64(grid.candidates[cell]);
+            if (count < bestCount) {
+                bestCount = count;
+                bestCell = cell;
+            }
+        }
+    }
+    if (bestCell < 0) {
+        return;
+    }
+
+    uint64_t mask = grid.candidates[bestCell];
+    while (mask != 0 && rating.numSolutions < 2) {
+        if (nodeLimit > 0 && rating.nodes >= nodeLimit) {
+            rating.searchAborted = true;
+            return;
+        }
+        int value = lowestBit64(mask);
+        mask &= mask - 1;
+
+        Grid child = grid;
+        place(child, bestCell, value);
+        ++rating.nodes;
+        rating.techniqueUses[static_cast<int>(Technique::Search)]++;
+
+        int result = propagate(child, Technique::HiddenSingle, nullptr);
+        if (result < 0) {
+            ++rating.backtracks;
+        } else if (result > 0) {
+            ++rating.numSolutions;
+        } else {
+            int before = rating.numSolutions;
+            search(child, rating);
+            if (rating.numSolutions == before) {
+                ++rating.backtracks;
+            }
+        }
+    }
+}
+
+// Rate a single puzzle
+DifficultyRating DifficultyRater::rate(const std::vector<int>& board) const {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    DifficultyRating rating;
+    rating.hardest = Technique::None;
+    std::fill(rating.techniqueUses, rating.techniqueUses + NUM_TECHNIQUES, 0);
+    rating.nodes = 0;
+    rating.backtracks = 0;
+    rating.numSolutions = 0;
+    rating.searchAborted = false;
+    rating.givens = 0;
+    for (int value : board) {
+        if (value != 0) {
+            ++rating.givens;
+        }
+    }
+
+    Grid grid;
+    if (board.size() == static_cast<size_t>(N * N) && initGrid(board, grid)) {
+        int result = propagate(grid, Technique::HiddenSubset, &rating);
+        if (result > 0) {
+            // Every technique is a sound deduction, so a logical solve is unique
+            rating.numSolutions = 1;
+        } else if (result == 0) {
+            rating.hardest = Technique::Search;
+            search(grid, rating);
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    rating.timeMs = duration.count();
+    return rating;
+}
+
+// Settings
+void DifficultyRater::setMaxSubsetSize(int size) {
+    maxSubsetSize = std::max(1, std::min(size, 4));
+}
+
+void DifficultyRater::setNodeLimit(long long limit) {
+    nodeLimit = limit;
+}
+
+int DifficultyRater::getSize() const {
+    return N;
+}
+
+// Rate a corpus of puzzles in parallel, one rater per board size
+void rateCorpus(const std::vector<Puzzle>& puzzles, int numThreads, long long nodeLimit,
+                std::vector<DifficultyRating>& ratings) {
+    std::map<int, DifficultyRater> raters;
+    for (const Puzzle& puzzle : puzzles) {
+        if (raters.find(puzzle.N) == raters.end()) {
+            DifficultyRater rater(puzzle.N);
+            rater.setNodeLimit(nodeLimit);
+            raters.emplace(puzzle.N, rater);
+        }
+    }
+
+    omp_set_num_threads(numThreads);
+
+    int numPuzzles = static_cast<int>(puzzles.size());
+    ratings.resize(numPuzzles);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numPuzzles; ++i) {
+        ratings[i] = raters.at(puzzles[i].N).rate(puzzles[i].board);
+    }
+}
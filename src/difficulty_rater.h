@@ -0,0 +1,93 @@
+#ifndef DIFFICULTY_RATER_H
+#define DIFFICULTY_RATER_H
+
+#include <vector>
+#include <cstdint>
+#include "puzzle_io.h"
+
+// Solving techniques in increasing order of difficulty
+enum class Technique {
+    None = 0,           // Board already complete
+    NakedSingle,        // Cell with a single candidate
+    HiddenSingle,       // Value with a single possible cell in a unit
+    LockedCandidates,   // Pointing / claiming between a block and a row or column
+    NakedSubset,        // k cells of a unit sharing exactly k candidates (k = 2..4)
+    HiddenSubset,       // k values of a unit confined to exactly k cells (k = 2..4)
+    Search              // Logic alone is not enough, backtracking required
+};
+
+const int NUM_TECHNIQUES = 7;
+
+// Human-readable technique name
+const char* techniqueName(Technique technique);
+
+// Result of rating one puzzle
+struct DifficultyRating {
+    Technique hardest;                     // Hardest technique needed to solve the puzzle
+    long long techniqueUses[NUM_TECHNIQUES];  // Number of steps made with each technique
+    long long nodes;                       // Search nodes visited (0 if solved by logic)
+    long long backtracks;                  // Search branches that failed
+    int numSolutions;                      // 0 = none, 1 = unique, 2 = more than one
+    bool searchAborted;                    // Node limit reached before the search finished
+    int givens;                            // Number of filled cells in the input
+    double timeMs;                         // Time taken to rate (in milliseconds)
+};
+
+// Rates puzzles by the techniques needed to solve them and the search effort left over
+class DifficultyRater {
+private:
+    int N;              // Size of the board (N x N)
+    int blockSize;      // Size of each block (sqrt(N))
+    uint64_t fullMask;  // Bits 1..N set
+    int maxSubsetSize;  // Largest naked / hidden subset considered
+    long long nodeLimit;  // Search nodes allowed per puzzle (0 = unlimited)
+
+    std::vector<int> unitCells;   // 3N units of N cells: rows, then columns, then blocks
+    std::vector<int> peerCells;   // Peers of each cell, peerCount entries per cell
+    int peerCount;
+
+    // Working grid: placed values and remaining candidates of every cell
+    struct Grid {
+        std::vector<int> values;
+        std::vector<uint64_t> candidates;
+        int numFilled;
+    };
+
+    bool initGrid(const std::vector<int>& board, Grid& grid) const;
+    void place(Grid& grid, int cell, int value) const;
+
+    // Technique steps return the number of placements / eliminations made,
+    // 0 if nothing applies, or -1 on a contradiction
+    int applyNakedSingles(Grid& grid) const;
+    int applyHiddenSingles(Grid& grid) const;
+    int applyLockedCandidates(Grid& grid) const;
+    int applyNakedSubsets(Grid& grid) const;
+    int applyHiddenSubsets(Grid& grid) const;
+    int findNakedSubset(Grid& grid, const int* cells, const std::vector<int>& pool, int start,
+                        int size, int chosen, uint64_t unionMask, uint64_t chosenCells) const;
+    int findHiddenSubset(Grid& grid, const int* cells, const std::vector<uint64_t>& positions,
+                         const std::vector<int>& pool, int start, int size, int chosen,
+                         uint64_t valueMask, uint64_t unionPositions) const;
+
+    // Apply techniques up to maxLevel until stuck: 1 solved, 0 stuck, -1 contradiction
+    int propagate(Grid& grid, Technique maxLevel, DifficultyRating* rating) const;
+    void search(Grid& grid, DifficultyRating& rating) const;
+
+public:
+    // Constructor
+    DifficultyRater(int N);
+
+    // Rate a single puzzle
+    DifficultyRating rate(const std::vector<int>& board) const;
+
+    // Settings
+    void setMaxSubsetSize(int size);
+    void setNodeLimit(long long limit);
+    int getSize() const;
+};
+
+// Rate a corpus of puzzles (of any sizes) in parallel
+void rateCorpus(const std::vector<Puzzle>& puzzles, int numThreads, long long nodeLimit,
+                std::vector<DifficultyRating>& ratings);
+
+#endif // DIFFICULTY_RATER_H
@@ -0,0 +1,510 @@
+#include "distributed.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <deque>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <omp.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SUDOKU_HAVE_SOCKETS 1
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#ifdef SUDOKU_HAVE_SOCKETS
+
+// Buffered line reader and writer over a connected socket
+class LineChannel {
+public:
+    explicit LineChannel(int fd) : fd(fd) {}
+
+    int getFd() const { return fd; }
+
+    // Send a whole message; false once the peer is gone
+    bool send(const std::string& message) {
+        size_t sent = 0;
+        while (sent < message.size()) {
+            ssize_t n = ::send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Read what is available (blocks if nothing is); false on EOF or error
+    bool fill() {
+        char chunk[65536];
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    // Take one complete line from the buffer
+    bool nextLine(std::string& line) {
+        size_t end = buffer.find('\n');
+        if (end == std::string::npos) {
+            return false;
+        }
+        line = buffer.substr(0, end);
+        buffer.erase(0, end + 1);
+        return true;
+    }
+
+    // Blocking read of one line
+    bool readLine(std::string& line) {
+        while (!nextLine(line)) {
+            if (!fill()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    int fd;
+    std::string buffer;
+};
+
+// A chunk of the frontier
+struct Lease {
+    int begin;               // First subproblem
+    int end;                 // One past the last
+    bool done;
+    int holder;              // Worker slot holding the lease, -1 if queued
+    double deadline;
+};
+
+// A connected worker
+struct WorkerConnection {
+    LineChannel channel;
+    int lease;               // Lease being counted, -1 if idle
+    bool ready;              // Said HELLO
+
+    explicit WorkerConnection(int fd) : channel(fd), lease(-1), ready(false) {}
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // SUDOKU_HAVE_SOCKETS
+
+Coordinator::Coordinator(int N, const std::vector<int>& board)
+    : N(N), board(board), partitionDepth(3), chunkSize(8), leaseTimeout(600.0), idleTimeout(30.0),
+      listenFd(-1), port(0) {}
+
+Coordinator::~Coordinator() {
+#ifdef SUDOKU_HAVE_SOCKETS
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+#endif
+}
+
+void Coordinator::setPartitionDepth(int depth) {
+    partitionDepth = depth;
+}
+
+void Coordinator::setChunkSize(int subproblems) {
+    chunkSize = std::max(1, subproblems);
+}
+
+void Coordinator::setLeaseTimeout(double seconds) {
+    leaseTimeout = seconds;
+}
+
+void Coordinator::setIdleTimeout(double seconds) {
+    idleTimeout = seconds;
+}
+
+int Coordinator::getPort() const {
+    return port;
+}
+
+bool Coordinator::listen(int requestedPort, const std::string& bindAddress) {
+#ifdef SUDOKU_HAVE_SOCKETS
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(requestedPort));
+    if (!bindAddress.empty() && inet_pton(AF_INET, bindAddress.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "Error: Invalid bind address " << bindAddress << std::endl;
+        return false;
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error: Could not create socket" << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, 64) != 0) {
+        std::cerr << "Error: Could not listen on " << (bindAddress.empty() ? "127.0.0.1" : bindAddress)
+                  << ":" << requestedPort << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+    return true;
+#else
+    (void)requestedPort;
+    (void)bindAddress;
+    std::cerr << "Error: Distributed counting needs POSIX sockets" << std::endl;
+    return false;
+#endif
+}
+
+bool Coordinator::run(DistributedStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    stats = DistributedStats();
+#ifdef SUDOKU_HAVE_SOCKETS
+    if (listenFd < 0) {
+        std::cerr << "Error: Coordinator is not listening" << std::endl;
+        return false;
+    }
+
+    SudokuSolver solver(N);
+    solver.loadBoard(board);
+    std::vector<Subproblem> subproblems;
+    solver.generateSubproblems(partitionDepth, subproblems);
+    stats.numSubproblems = static_cast<int>(subproblems.size());
+
+    std::vector<Lease> leases;
+    std::deque<int> queue;
+    for (int begin = 0; begin < stats.numSubproblems; begin += chunkSize) {
+        Lease lease = {begin, std::min(begin + chunkSize, stats.numSubproblems), false, -1, 0.0};
+        queue.push_back(static_cast<int>(leases.size()));
+        leases.push_back(lease);
+    }
+    stats.numLeases = static_cast<int>(leases.size());
+    int leasesLeft = stats.numLeases;
+
+    std::vector<WorkerConnection*> workers;   // Slots; nullptr once disconnected
+    double lastWorkerSeen = 0.0;
+
+    // Put a lease back in the queue (it stays countable by its old holder)
+    auto requeue = [&](int leaseIndex) {
+        Lease& lease = leases[leaseIndex];
+        if (!lease.done && lease.holder >= 0) {
+            lease.holder = -1;
+            queue.push_front(leaseIndex);
+            stats.reassignedLeases++;
+        }
+    };
+
+    auto drop = [&](int slot) {
+        WorkerConnection* worker = workers[slot];
+        if (worker->lease >= 0 && !leases[worker->lease].done) {
+            stats.workersLost++;
+            if (leases[worker->lease].holder == slot) {
+                requeue(worker->lease);
+            }
+        }
+        close(worker->channel.getFd());
+        delete worker;
+        workers[slot] = nullptr;
+    };
+
+    // Give the next queued lease to an idle worker
+    auto assign = [&](int slot) {
+        WorkerConnection* worker = workers[slot];
+        while (!queue.empty() && leases[queue.front()].done) {
+            queue.pop_front();
+        }
+        if (queue.empty()) {
+            return;
+        }
+        int leaseIndex = queue.front();
+        queue.pop_front();
+        Lease& lease = leases[leaseIndex];
+        std::ostringstream message;
+        message << "LEASE " << leaseIndex << " " << (lease.end - lease.begin) << "\n";
+        for (int i = lease.begin; i < lease.end; ++i) {
+            message << subproblems[i].startPos;
+            for (int value : subproblems[i].board) {
+                message << " " << value;
+            }
+            message << "\n";
+        }
+        lease.holder = slot;
+        lease.deadline = secondsSince(start) + leaseTimeout;
+        worker->lease = leaseIndex;
+        stats.leasesGranted++;
+        if (!worker->channel.send(message.str())) {
+            drop(slot);
+        }
+    };
+
+    while (leasesLeft > 0) {
+        std::vector<pollfd> fds;
+        std::vector<int> slots;
+        fds.push_back({listenFd, POLLIN, 0});
+        slots.push_back(-1);
+        for (size_t slot = 0; slot < workers.size(); ++slot) {
+            if (workers[slot] != nullptr) {
+                fds.push_back({workers[slot]->channel.getFd(), POLLIN, 0});
+                slots.push_back(static_cast<int>(slot));
+            }
+        }
+        if (fds.size() > 1) {
+            lastWorkerSeen = secondsSince(start);
+        } else if (secondsSince(start) - lastWorkerSeen > idleTimeout) {
+            std::cerr << "Error: No workers connected for " << idleTimeout << " s; "
+                      << leasesLeft << " leases left" << std::endl;
+            break;
+        }
+
+        poll(fds.data(), fds.size(), 200);
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd >= 0) {
+                int noDelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                workers.push_back(new WorkerConnection(fd));
+                stats.workersSeen++;
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); ++i) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            int slot = slots[i];
+            WorkerConnection* worker = workers[slot];
+            if (!worker->channel.fill()) {
+                drop(slot);
+                continue;
+            }
+            std::string line;
+            bool alive = true;
+            while (alive && worker->channel.nextLine(line)) {
+                std::istringstream message(line);
+                std::string kind;
+                message >> kind;
+                if (kind == "HELLO") {
+                    worker->ready = true;
+                    alive = worker->channel.send("JOB " + std::to_string(N) + "\n");
+                } else if (kind == "DONE") {
+                    int leaseIndex = -1;
+                    long long count = 0;
+                    message >> leaseIndex >> count;
+                    // Only the worker the lease was granted to may answer it; its
+                    // worker->lease still names the lease after a timeout reassigns it
+                    if (!message || leaseIndex < 0 || leaseIndex >= stats.numLeases ||
+                        (worker->lease != leaseIndex && leases[leaseIndex].holder != slot)) {
+                        std::cerr << "Warning: Malformed result from a worker dropped" << std::endl;
+                        alive = false;
+                        break;
+                    }
+                    if (leases[leaseIndex].done) {
+                        stats.duplicateResults++;
+                    } else {
+                        leases[leaseIndex].done = true;
+                        leases[leaseIndex].holder = -1;
+                        stats.solutions += count;
+                        leasesLeft--;
+                    }
+                    worker->lease = -1;
+                }
+            }
+            if (!alive) {
+                drop(slot);
+            }
+        }
+
+        // Take back leases whose holder is too slow; the holder may still finish them
+        double now = secondsSince(start);
+        for (size_t leaseIndex = 0; leaseIndex < leases.size(); ++leaseIndex) {
+            if (!leases[leaseIndex].done && leases[leaseIndex].holder >= 0 && now > leases[leaseIndex].deadline) {
+                requeue(static_cast<int>(leaseIndex));
+            }
+        }
+
+        for (size_t slot = 0; slot < workers.size(); ++slot) {
+            if (workers[slot] != nullptr && workers[slot]->ready && workers[slot]->lease < 0) {
+                assign(static_cast<int>(slot));
+            }
+        }
+    }
+
+    for (WorkerConnection* worker : workers) {
+        if (worker != nullptr) {
+            worker->channel.send("STOP\n");
+            close(worker->channel.getFd());
+            delete worker;
+        }
+    }
+    stats.timeMs = secondsSince(start) * 1000.0;
+    return leasesLeft == 0;
+#else
+    std::cerr << "Error: Distributed counting needs POSIX sockets" << std::endl;
+    return false;
+#endif
+}
+
+bool runWorker(const std::string& host, int port, int numThreads, int failAfterLeases) {
+#ifdef SUDOKU_HAVE_SOCKETS
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        std::cerr << "Error: Could not resolve " << host << std::endl;
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    bool connected = fd >= 0 && connect(fd, addresses->ai_addr, addresses->ai_addrlen) == 0;
+    freeaddrinfo(addresses);
+    if (!connected) {
+        std::cerr << "Error: Could not connect to " << host << ":" << port << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    LineChannel channel(fd);
+    channel.send("HELLO\n");
+    SudokuSolver* solver = nullptr;
+    int N = 0;
+    int leasesReceived = 0;
+    std::string line;
+    bool ok = false;
+    while (channel.readLine(line)) {
+        std::istringstream message(line);
+        std::string kind;
+        message >> kind;
+        if (kind == "JOB") {
+            message >> N;
+            // Same limits as SudokuSolver: a perfect square that fits the 64-bit masks
+            int root = 1;
+            while (root * root < N) {
+                ++root;
+            }
+            if (!message || N < 1 || N > 63 || root * root != N) {
+                std::cerr << "Error: Coordinator sent an unsupported size" << std::endl;
+                break;
+            }
+            delete solver;
+            solver = new SudokuSolver(N);
+        } else if (kind == "LEASE" && solver != nullptr) {
+            int leaseIndex = 0;
+            int count = 0;
+            message >> leaseIndex >> count;
+            bool valid = static_cast<bool>(message) && count >= 0;
+            // Grow with the lines actually received rather than trusting count up front
+            std::vector<Subproblem> subproblems;
+            for (int i = 0; i < count && valid; ++i) {
+                valid = channel.readLine(line);
+                std::istringstream entry(line);
+                subproblems.emplace_back(N);
+                Subproblem& subproblem = subproblems.back();
+                entry >> subproblem.startPos;
+                valid = valid && entry && subproblem.startPos >= 0 && subproblem.startPos <= N * N;
+                subproblem.board.assign(N * N, 0);
+                for (int cell = 0; cell < N * N && valid; ++cell) {
+                    entry >> subproblem.board[cell];
+                    valid = entry && subproblem.board[cell] >= 0 && subproblem.board[cell] <= N;
+                    if (valid && subproblem.board[cell] != 0) {
+                        subproblem.state.set(N, solver->getBlockSize(), cell / N, cell % N, subproblem.board[cell]);
+                    }
+                }
+            }
+            if (!valid) {
+                std::cerr << "Error: Malformed lease from the coordinator" << std::endl;
+                break;
+            }
+            if (failAfterLeases > 0 && ++leasesReceived >= failAfterLeases) {
+                // Simulated crash: no answer, no goodbye
+                std::_Exit(3);
+            }
+
+            long long total = 0;
+            #pragma omp parallel for schedule(dynamic) num_threads(numThreads) reduction(+:total)
+            for (int i = 0; i < count; ++i) {
+                total += solver->solveSubproblem(subproblems[i]);
+            }
+            if (!channel.send("DONE " + std::to_string(leaseIndex) + " " + std::to_string(total) + "\n")) {
+                break;
+            }
+        } else if (kind == "STOP") {
+            ok = true;
+            break;
+        }
+    }
+    delete solver;
+    close(fd);
+    return ok;
+#else
+    (void)host;
+    (void)port;
+    (void)numThreads;
+    (void)failAfterLeases;
+    std::cerr << "Error: Distributed counting needs POSIX sockets" << std::endl;
+    return false;
+#endif
+}
+
+int spawnLocalWorker(const std::string& executable, int port, int numThreads, int failAfterLeases) {
+#ifdef SUDOKU_HAVE_SOCKETS
+    std::string portArg = std::to_string(port);
+    std::string threadArg = std::to_string(numThreads);
+    std::string failArg = std::to_string(failAfterLeases);
+    char* args[] = {const_cast<char*>(executable.c_str()), const_cast<char*>("worker"),
+                    const_cast<char*>("127.0.0.1"), const_cast<char*>(portArg.c_str()),
+                    const_cast<char*>(threadArg.c_str()), const_cast<char*>(failArg.c_str()), nullptr};
+    pid_t pid = fork();
+    if (pid == 0) {
+        // argv[0] may be a bare name found through PATH, so prefer the running binary
+        execv("/proc/self/exe", args);
+        execvp(executable.c_str(), args);
+        std::cerr << "Error: Could not start worker " << executable << ": " << std::strerror(errno) << std::endl;
+        std::_Exit(127);
+    }
+    return static_cast<int>(pid);
+#else
+    (void)executable;
+    (void)port;
+    (void)numThreads;
+    (void)failAfterLeases;
+    return -1;
+#endif
+}
+
+int waitForWorker(int pid) {
+#ifdef SUDOKU_HAVE_SOCKETS
+    int status = 0;
+    if (pid <= 0 || waitpid(static_cast<pid_t>(pid), &status, 0) != pid || !WIFEXITED(status)) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+#else
+    (void)pid;
+    return -1;
+#endif
+}
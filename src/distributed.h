@@ -0,0 +1,74 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include <vector>
+#include <string>
+#include "sudoku_solver.h"
+
+// Outcome of a distributed count
+struct DistributedStats {
+    long long solutions;
+    int numSubproblems;      // Frontier size
+    int numLeases;           // Chunks of the frontier
+    int leasesGranted;       // Including grants of reassigned leases
+    int reassignedLeases;    // Leases taken back from lost or late workers
+    int duplicateResults;    // Results for leases already counted (ignored)
+    int workersSeen;
+    int workersLost;         // Disconnected while holding a lease
+    double timeMs;
+};
+
+// Hands out chunks of the solveParallelOptimized frontier to worker processes over
+// TCP and sums their counts. Messages are text lines:
+//   worker -> coordinator   HELLO | DONE <lease> <solutions>
+//   coordinator -> worker   JOB <N> | LEASE <lease> <count> + count lines
+//                           "<startPos> <N*N values>" | STOP
+// There is no authentication, so the coordinator listens on loopback unless a bind
+// address is given. A worker holds one lease at a time. When it disconnects or misses the lease
+// deadline, its lease goes back to the queue. Each lease is counted once, the first
+// time it completes, so a lost or slow worker cannot corrupt the total. A result for
+// a lease the worker was not given is treated as malformed and the worker dropped.
+// POSIX sockets only; elsewhere run() reports an error.
+class Coordinator {
+private:
+    int N;
+    std::vector<int> board;
+    int partitionDepth;
+    int chunkSize;           // Subproblems per lease
+    double leaseTimeout;     // Seconds before a lease is given to another worker
+    double idleTimeout;      // Give up after this long without any connected worker
+    int listenFd;
+    int port;
+
+public:
+    Coordinator(int N, const std::vector<int>& board);
+    ~Coordinator();
+
+    void setPartitionDepth(int depth);
+    void setChunkSize(int subproblems);
+    void setLeaseTimeout(double seconds);
+    void setIdleTimeout(double seconds);
+
+    // Listen on port (0 picks a free port) at the IPv4 bindAddress; empty means
+    // 127.0.0.1, "0.0.0.0" all interfaces
+    bool listen(int port, const std::string& bindAddress = "");
+    int getPort() const;
+
+    // Generate the frontier and serve leases until every one is counted
+    bool run(DistributedStats& stats);
+};
+
+// Connect to a coordinator and count leases with numThreads threads until told to
+// stop. failAfterLeases > 0 makes the worker exit without answering once it receives
+// that many leases, to exercise reassignment. Returns false on connection errors.
+bool runWorker(const std::string& host, int port, int numThreads, int failAfterLeases);
+
+// Start "executable worker 127.0.0.1 <port> <numThreads> <failAfterLeases>" as a
+// child process; returns its process id, or -1. The running binary (/proc/self/exe)
+// is used where available, otherwise executable is looked up through PATH.
+int spawnLocalWorker(const std::string& executable, int port, int numThreads, int failAfterLeases);
+
+// Wait for a spawned worker; returns its exit status, or -1 if it was killed
+int waitForWorker(int pid);
+
+#endif // DISTRIBUTED_H
@@ -0,0 +1,301 @@
+#include "grid_generator.h"
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <omp.h>
+
+// Constructor
+GridGenerator::GridGenerator(int N, uint64_t seed)
+    : N(N), seed(seed), numRestarts(0), runningTime(0.0) {
+    blockSize = static_cast<int>(sqrt(N));
+
+    // Validate that N is a perfect square
+    if (blockSize * blockSize != N) {
+        std::cerr << "Warning: N=" << N << " is not a perfect square. "
+                  << "Sudoku constraints may not work correctly." << std::endl;
+    }
+
+    // Validate that N is within bitmask range
+    if (N > 63) {
+        std::cerr << "Error: N=" << N << " exceeds maximum supported size of 63 "
+                  << "for bitmask optimization. Please use N <= 49." << std::endl;
+    }
+
+    // Random fills rarely need more than a few nodes per cell; unlucky attempts
+    // are cut off and restarted instead of exploring a heavy-tailed subtree
+    nodeLimit = 4LL * N * N;
+
+    // Hidden-single detection costs a pass over all units per node; it only pays
+    // off on large boards, where plain MRV runs into dead ends far more often
+    useHiddenSingles = (N >= 25);
+}
+
+// Randomized MRV search: fill the empty cell with the fewest candidates (or the
+// only cell left for a value in some unit), trying candidates in random order.
+// Stops at the first complete grid.
+bool GridGenerator::searchRandom(std::vector<int>& grid, BitMaskState& state, std::vector<int>& emptyCells,
+                                 int depth, SplitMix64& rng, long long& budget, SearchScratch& scratch) {
+    int numEmpty = static_cast<int>(emptyCells.size());
+    if (depth == numEmpty) {
+        return true;
+    }
+    if (--budget < 0) {
+        return false;
+    }
+
+    // Select the most constrained cell, accumulating per-unit candidate
+    // occurrences ("seen once" / "seen twice") on the way
+    if (useHiddenSingles) {
+        std::fill(scratch.seenOnce.begin(), scratch.seenOnce.end(), 0);
+        std::fill(scratch.seenTwice.begin(), scratch.seenTwice.end(), 0);
+    }
+
+    int bestIdx = depth;
+    int bestCount = N + 1;
+    uint64_t bestMask = 0;
+    for (int i = depth; i < numEmpty; ++i) {
+        int pos = emptyCells[i];
+        int row = pos / N;
+        int col = pos % N;
+        uint64_t mask = state.candidates(N, blockSize, row, col);
+        int count = popcount64(mask);
+        if (count < bestCount) {
+            bestCount = count;
+            bestMask = mask;
+            bestIdx = i;
+            if (count <= 1) {
+                break;  // Dead end or naked single, no need to look further
+            }
+        }
+        if (!useHiddenSingles) {
+            continue;
+        }
+        scratch.candidates[i] = mask;
+        int units[3] = { row, N + col, 2 * N + (row / blockSize) * blockSize + (col / blockSize) };
+        for (int unit : units) {
+            scratch.seenTwice[unit] |= scratch.seenOnce[unit] & mask;
+            scratch.seenOnce[unit] |= mask;
+        }
+    }
+
+    if (bestCount == 0) {
+        return false;  // Dead end
+    }
+
+    if (useHiddenSingles && bestCount > 1) {
+        // A value missing from every empty cell of a unit is a contradiction; a value
+        // seen exactly once in a unit is a hidden single and is placed directly
+        uint64_t fullMask = ((1ull << (N + 1)) - 1) & ~1ull;
+        int hiddenUnit = -1;
+        uint64_t hiddenMask = 0;
+        for (int unit = 0; unit < 3 * N; ++unit) {
+            int idx = unit % N;
+            uint64_t used = (unit < N) ? state.rowMask[idx]
+                          : (unit < 2 * N) ? state.colMask[idx]
+                          : state.blockMask[idx];
+            if (fullMask & ~(used | scratch.seenOnce[unit])) {
+                return false;
+            }
+            uint64_t hidden = scratch.seenOnce[unit] & ~scratch.seenTwice[unit];
+            if (hidden != 0 && hiddenUnit < 0) {
+                hiddenUnit = unit;
+                hiddenMask = hidden & (~hidden + 1);
+            }
+        }
+
+        if (hiddenUnit >= 0) {
+            int idx = hiddenUnit % N;
+            for (int i = depth; i < numEmpty; ++i) {
+                int pos = emptyCells[i];
+                int row = pos / N;
+                int col = pos % N;
+                int cellUnit = (hiddenUnit < N) ? row
+                             : (hiddenUnit < 2 * N) ? col
+                             : (row / blockSize) * blockSize + (col / blockSize);
+                if (cellUnit == idx && (scratch.candidates[i] & hiddenMask)) {
+                    bestIdx = i;
+                    bestMask = hiddenMask;
+                    bestCount = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::swap(emptyCells[depth], emptyCells[bestIdx]);
+    int pos = emptyCells[depth];
+    int row = pos / N;
+    int col = pos % N;
+
+    uint64_t remaining = bestMask;
+    int remainingCount = bestCount;
+    while (remaining != 0) {
+        int value = nthBit64(remaining, static_cast<int>(rng.below(remainingCount)));
+        remaining &= ~(1ull << value);
+        --remainingCount;
+
+        grid[pos] = value;
+        state.set(N, blockSize, row, col, value);
+
+        if (searchRandom(grid, state, emptyCells, depth + 1, rng, budget, scratch)) {
+            return true;
+        }
+
+        grid[pos] = 0;
+        state.unset(N, blockSize, row, col, value);
+
+        if (budget < 0) {
+            break;  // Out of budget, unwind for a restart
+        }
+    }
+
+    std::swap(emptyCells[depth], emptyCells[bestIdx]);
+    return false;
+}
+
+// Generate a grid from the given random stream, restarting when the node budget runs out
+bool GridGenerator::generateWithRng(std::vector<int>& grid, SplitMix64& rng, long long& restarts) {
+    std::vector<int> emptyCells;
+    emptyCells.reserve(N * N);
+    SearchScratch scratch;
+    scratch.candidates.resize(N * N);
+    scratch.seenOnce.resize(3 * N);
+    scratch.seenTwice.resize(3 * N);
+
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        grid.assign(N * N, 0);
+        BitMaskState state(N);
+
+        // Any permutation of the first row extends to a full grid (relabel the
+        // digits of any solution), so it is filled directly without search
+        for (int col = 0; col < N; ++col) {
+            grid[col] = col + 1;
+        }
+        for (int col = N - 1; col > 0; --col) {
+            int other = static_cast<int>(rng.below(col + 1));
+            std::swap(grid[col], grid[other]);
+        }
+        for (int col = 0; col < N; ++col) {
+            state.set(N, blockSize, 0, col, grid[col]);
+        }
+
+        emptyCells.clear();
+        for (int pos = N; pos < N * N; ++pos) {
+            emptyCells.push_back(pos);
+        }
+
+        long long budget = nodeLimit;
+        if (searchRandom(grid, state, emptyCells, 0, rng, budget, scratch)) {
+            return true;
+        }
+        ++restarts;
+    }
+
+    return false;
+}
+
+// Generate one grid deterministically from (seed, gridIndex)
+bool GridGenerator::generate(std::vector<int>& grid, uint64_t gridIndex) {
+    SplitMix64 rng(seed ^ (gridIndex * 0xD1B54A32D192ED03ull));
+    rng.next();
+    long long restarts = 0;
+    bool ok = generateWithRng(grid, rng, restarts);
+    numRestarts = restarts;
+    return ok;
+}
+
+// Generate a batch of grids in parallel
+long long GridGenerator::generateBatch(long long count, int numThreads, std::vector<int>* grids) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    omp_set_num_threads(numThreads);
+
+    const size_t cells = static_cast<size_t>(N) * N;
+    std::vector<char> produced;
+    if (grids != nullptr) {
+        grids->assign(static_cast<size_t>(count) * cells, 0);
+        produced.assign(static_cast<size_t>(count), 0);
+    }
+
+    long long numValid = 0;
+    long long totalRestarts = 0;
+
+    #pragma omp parallel reduction(+:numValid, totalRestarts)
+    {
+        // Each thread reuses one scratch grid; output goes straight to its slot
+        std::vector<int> grid;
+
+        #pragma omp for schedule(dynamic, 256)
+        for (long long i = 0; i < count; ++i) {
+            SplitMix64 rng(seed ^ (static_cast<uint64_t>(i) * 0xD1B54A32D192ED03ull));
+            rng.next();
+            if (!generateWithRng(grid, rng, totalRestarts) || !isValidGrid(grid)) {
+                continue;
+            }
+            if (grids != nullptr) {
+                std::copy(grid.begin(), grid.end(), grids->begin() + static_cast<size_t>(i) * cells);
+                produced[i] = 1;
+            }
+            ++numValid;
+        }
+    }
+
+    // Close the gaps left by failed grids so only valid grids are handed back
+    if (grids != nullptr && numValid < count) {
+        size_t kept = 0;
+        for (long long i = 0; i < count; ++i) {
+            if (produced[i]) {
+                if (kept != static_cast<size_t>(i)) {
+                    std::copy_n(grids->begin() + static_cast<size_t>(i) * cells, cells, grids->begin() + kept * cells);
+                }
+                ++kept;
+            }
+        }
+        grids->resize(kept * cells);
+    }
+
+    numRestarts = totalRestarts;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    runningTime = duration.count();
+
+    return numValid;
+}
+
+// Check that every row, column and block holds each value 1..N exactly once
+bool GridGenerator::isValidGrid(const std::vector<int>& grid, size_t offset) const {
+    if (grid.size() < offset + static_cast<size_t>(N * N)) {
+        return false;
+    }
+
+    BitMaskState state(N);
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < N; ++col) {
+            int value = grid[offset + row * N + col];
+            if (value < 1 || value > N || !state.canPlace(N, blockSize, row, col, value)) {
+                return false;
+            }
+            state.set(N, blockSize, row, col, value);
+        }
+    }
+    return true;
+}
+
+// Query methods
+void GridGenerator::setNodeLimit(long long limit) {
+    nodeLimit = limit;
+}
+
+long long GridGenerator::getNumRestarts() const {
+    return numRestarts;
+}
+
+double GridGenerator::getRunningTime() const {
+    return runningTime;
+}
+
+int GridGenerator::getSize() const {
+    return N;
+}
@@ -0,0 +1,53 @@
+#ifndef GRID_GENERATOR_H
+#define GRID_GENERATOR_H
+
+#include <vector>
+#include <cstdint>
+#include "sudoku_solver.h"
+#include "bit_utils.h"
+
+// Generates random completed N x N grids with a randomized first-solution search
+class GridGenerator {
+private:
+    int N;              // Size of the board (N x N)
+    int blockSize;      // Size of each block (sqrt(N))
+    uint64_t seed;      // Base seed; grid i of a batch is derived from (seed, i)
+    long long nodeLimit;     // Node budget per attempt before restarting
+    bool useHiddenSingles;   // Also place values that fit only one cell of a unit
+    long long numRestarts;   // Restarts taken during the last generate/batch call
+    double runningTime;      // Time taken by the last batch (in milliseconds)
+
+    // Per-search scratch buffers, reused across recursion levels
+    struct SearchScratch {
+        std::vector<uint64_t> candidates;  // Candidate mask of each empty cell
+        std::vector<uint64_t> seenOnce;    // Per unit: values possible in at least one cell
+        std::vector<uint64_t> seenTwice;   // Per unit: values possible in at least two cells
+    };
+
+    bool searchRandom(std::vector<int>& grid, BitMaskState& state, std::vector<int>& emptyCells,
+                      int depth, SplitMix64& rng, long long& budget, SearchScratch& scratch);
+    bool generateWithRng(std::vector<int>& grid, SplitMix64& rng, long long& restarts);
+
+public:
+    // Constructor
+    GridGenerator(int N, uint64_t seed);
+
+    // Generate one grid; the same gridIndex always yields the same grid for a given seed
+    bool generate(std::vector<int>& grid, uint64_t gridIndex);
+
+    // Generate count grids using numThreads threads and validate each one. If grids is
+    // non-null the valid grids are stored back to back in index order (numValid * N * N
+    // values); grids that fail are left out. Returns the number of valid grids produced.
+    long long generateBatch(long long count, int numThreads, std::vector<int>* grids);
+
+    // Check that grid is a complete, valid solution
+    bool isValidGrid(const std::vector<int>& grid, size_t offset = 0) const;
+
+    // Query methods
+    void setNodeLimit(long long limit);
+    long long getNumRestarts() const;
+    double getRunningTime() const;
+    int getSize() const;
+};
+
+#endif // GRID_GENERATOR_H
@@ -1,7 +1,22 @@
 #include "sudoku_solver.h"
+#include "grid_generator.h"
+#include "difficulty_rater.h"
+#include "puzzle_io.h"
+#include "system_info.h"
+#include "bench_stats.h"
+#include "symmetry_counter.h"
+#include "row_dp_counter.h"
+#include "distributed.h"
 #include <iostream>
+#include <fstream>
 #include <vector>
+#include <string>
+#include <cstdlib>
 #include <iomanip>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
 
 // Get a standard 9x9 test board with moderate difficulty
 std::vector<int> getTestBoard9x9() {
@@ -33,25 +48,25 @@ std::vector<int> getSimpleTestBoard9x9() {
     };
 }
 
-// Get a 16x16 test board
+// Get a 16x16 test board (one solution; derived from the 16x16-easy corpus grid)
 std::vector<int> getTestBoard16x16() {
     return {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+        10,  7, 16, 14,  0,  0,  9,  0, 15,  6,  0,  5,  3,  2,  4, 13,
+         0,  0,  0,  8, 16,  4, 14,  0,  9, 13,  3,  1,  0, 15,  0,  7,
+         0, 15,  0, 13,  6,  2,  0,  5, 10, 12,  0,  7, 16, 14,  0,  9,
+         3, 11,  0,  0,  0, 10, 15,  0,  0,  0, 14,  0,  0,  0,  0,  6,
+         0, 10,  8,  0,  0, 13,  4,  0,  0,  0,  0,  6,  7, 11,  3, 15,
+         0,  0,  0,  0,  0,  0, 11,  3, 14,  0, 15, 13,  9,  4,  0,  0,
+         6,  0, 11,  0,  0,  0,  5,  1,  3,  0,  0,  8,  2,  0,  0, 16,
+        15, 13,  3,  0,  0,  0,  0,  8,  0, 11,  0,  9,  0,  0,  6,  0,
+         0,  0,  0,  0,  1,  3, 13, 15,  2,  0,  0,  4, 12,  0, 14, 11,
+         0,  8, 13, 10,  0,  0, 12,  9,  0, 16,  0,  0, 15,  0,  0,  0,
+         7,  0, 15,  2,  0, 11,  0,  0,  0,  0,  0, 12,  6,  0,  0,  3,
+        14,  4,  0,  3,  5,  0,  0,  0, 11, 15,  0, 10,  0,  0,  0,  0,
+         4,  0,  6,  7, 11,  0,  1,  0,  8,  0, 10,  0, 14,  3, 16,  2,
+         0,  3,  0,  0,  0,  0,  0,  2, 12,  5, 16,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0, 16,  7,  3,  0,  2,  5,  0,  0, 10,
+         0,  2,  1,  0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  9,  0,  0
     };
 }
 
@@ -72,10 +87,12 @@ void runComprehensiveBenchmark(int N, const std::vector<int>& board) {
 
     double singleThreadTime = solver1.getRunningTime();
 
-  
-    std::vector<int> threadCounts = { 2, 4, 8 };
 
- 
+    // Powers of two up to the machine size, but at least up to 8 threads
+    std::vector<int> threadCounts = scalingThreadCounts(
+        std::max(8, static_cast<int>(std::thread::hardware_concurrency())));
+    threadCounts.erase(threadCounts.begin());  // 1 thread is the baseline above
+
     // Automatically choose partition depth based on board size
     int partitionDepth = (N == 9) ? 2 : (N == 16) ? 3 : 2;
 
@@ -97,7 +114,598 @@ void runComprehensiveBenchmark(int N, const std::vector<int>& board) {
     std::cout << "\n";
 }
 
+// Generate random completed grids and report throughput
+// Usage: sudoku_solver generate <N> <count> [numThreads] [seed] [outputFile]
+int runGenerateMode(int argc, char* argv[]) {
+    int N = (argc > 2) ? std::atoi(argv[2]) : 9;
+    long long count = (argc > 3) ? std::atoll(argv[3]) : 100000;
+    int numThreads = (argc > 4) ? std::atoi(argv[4]) : 4;
+    uint64_t seed = (argc > 5) ? std::strtoull(argv[5], nullptr, 10) : 1;
+    const char* outputFile = (argc > 6) ? argv[6] : nullptr;
+
+    std::cout << "=== Random Grid Generation for " << N << "x" << N << " ===\n";
+    std::cout << "Grids: " << count << ", Threads: " << numThreads << ", Seed: " << seed << "\n";
+
+    GridGenerator generator(N, seed);
+    std::vector<int> grids;
+    long long numValid = generator.generateBatch(count, numThreads, outputFile ? &grids : nullptr);
+
+    double seconds = generator.getRunningTime() / 1000.0;
+    double perSecond = (seconds > 0) ? numValid / seconds : 0.0;
+
+    std::cout << "Valid grids: " << numValid << " / " << count << "\n";
+    std::cout << "Restarts: " << generator.getNumRestarts() << "\n";
+    std::cout << "Time: " << std::fixed << std::setprecision(2) << generator.getRunningTime() << " ms\n";
+    std::cout << "Throughput: " << std::setprecision(0) << perSecond << " grids/s ("
+              << std::setprecision(2) << perSecond * 60.0 / 1e6 << " million grids/min)\n";
+
+    if (outputFile) {
+        std::ofstream out(outputFile);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not create " << outputFile << "\n";
+            return 1;
+        }
+        // One grid per line, values separated by spaces; failed grids are not written
+        for (long long i = 0; i < numValid; ++i) {
+            for (int cell = 0; cell < N * N; ++cell) {
+                out << grids[static_cast<size_t>(i) * N * N + cell] << (cell + 1 < N * N ? " " : "\n");
+            }
+        }
+        std::cout << numValid << " grids saved to " << outputFile << "\n";
+    }
+
+    return (numValid == count) ? 0 : 1;
+}
+
+// Rate every puzzle of a corpus file by required technique and search effort
+// Usage: sudoku_solver rate <puzzleFile> [numThreads] [outputCsv] [nodeLimit]
+int runRateMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " rate <puzzleFile> [numThreads] [outputCsv] [nodeLimit]\n";
+        return 1;
+    }
+    std::string puzzleFile = argv[2];
+    int numThreads = (argc > 3) ? std::atoi(argv[3]) : 4;
+    std::string outputFile = (argc > 4) ? argv[4] : "difficulty_ratings.csv";
+    long long nodeLimit = (argc > 5) ? std::atoll(argv[5]) : 1000000;
+
+    std::vector<Puzzle> puzzles;
+    if (!loadPuzzleFile(puzzleFile, puzzles)) {
+        return 1;
+    }
+
+    std::cout << "=== Difficulty Rating ===\n";
+    std::cout << "Puzzles: " << puzzles.size() << ", Threads: " << numThreads << "\n\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<DifficultyRating> ratings;
+    rateCorpus(puzzles, numThreads, nodeLimit, ratings);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+
+    std::ofstream csvFile(outputFile);
+    if (!csvFile.is_open()) {
+        std::cerr << "Error: Could not create " << outputFile << "\n";
+        return 1;
+    }
+    csvFile << "Line,Board Size,Givens,Hardest Technique,Solutions,Search Complete,Nodes,Backtracks,Time (ms)\n";
+
+    long long perTechnique[NUM_TECHNIQUES] = {};
+    long long totalNodes = 0;
+    int numAborted = 0;
+    for (size_t i = 0; i < puzzles.size(); ++i) {
+        const DifficultyRating& rating = ratings[i];
+        csvFile << puzzles[i].lineNumber << ","
+                << puzzles[i].N << ","
+                << rating.givens << ","
+                << techniqueName(rating.hardest) << ","
+                << rating.numSolutions << ","
+                << (rating.searchAborted ? "no" : "yes") << ","
+                << rating.nodes << ","
+                << rating.backtracks << ","
+                << std::fixed << std::setprecision(3) << rating.timeMs << "\n";
+        perTechnique[static_cast<int>(rating.hardest)]++;
+        totalNodes += rating.nodes;
+        numAborted += rating.searchAborted ? 1 : 0;
+    }
+
+    std::cout << "Hardest technique needed:\n";
+    for (int level = 0; level < NUM_TECHNIQUES; ++level) {
+        std::cout << "  " << std::left << std::setw(18) << techniqueName(static_cast<Technique>(level))
+                  << std::right << perTechnique[level] << "\n";
+    }
+    double seconds = duration.count() / 1000.0;
+    std::cout << "\nTotal search nodes: " << totalNodes << "\n";
+    std::cout << "Searches stopped at the node limit: " << numAborted << "\n";
+    std::cout << "Time: " << std::fixed << std::setprecision(2) << duration.count() << " ms ("
+              << std::setprecision(0) << ((seconds > 0) ? puzzles.size() / seconds : 0.0) << " puzzles/s)\n";
+    std::cout << "Ratings saved to " << outputFile << "\n";
+    return 0;
+}
+
+// Print a Monte Carlo estimate of the search effort for a board
+void printTreeSizeEstimate(const SudokuSolver& solver, int numProbes, int numThreads) {
+    TreeSizeEstimate estimate = solver.estimateSearchTree(numProbes, 12345);
+    double singleThreadSeconds = estimate.nodes * estimate.nsPerProbeStep / 1e9;
+
+    std::cout << "Estimated search nodes: " << std::scientific << std::setprecision(3) << estimate.nodes
+              << " (std. error " << estimate.nodesStdError << ", " << estimate.numProbes << " probes)\n";
+    std::cout << "Estimated solutions: " << estimate.solutions << "\n";
+    std::cout << "Rough time estimate: " << singleThreadSeconds << " s single-threaded, "
+              << singleThreadSeconds / numThreads << " s with " << numThreads << " threads\n";
+    std::cout << std::defaultfloat;
+}
+
+// Estimate (and optionally run) full solution counts for every puzzle of a file
+// Usage: sudoku_solver estimate <puzzleFile> [numThreads] [probes]
+//        sudoku_solver count <puzzleFile> [numThreads] [partitionDepth] [probes] [checkpointFile] [checkpointSeconds]
+int runCountMode(int argc, char* argv[], bool runSolver) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << (runSolver ? " count <puzzleFile> [numThreads] [partitionDepth] [probes]"
+                                                        " [checkpointFile] [checkpointSeconds]\n"
+                                                        "  (subproblems in progress at a stop are redone on resume)\n"
+                                                      : " estimate <puzzleFile> [numThreads] [probes]\n");
+        return 1;
+    }
+    int numThreads = (argc > 3) ? std::atoi(argv[3]) : 4;
+    int partitionDepth = (runSolver && argc > 4) ? std::atoi(argv[4]) : 3;
+    int probeArg = runSolver ? 5 : 4;
+    int numProbes = (argc > probeArg) ? std::atoi(argv[probeArg]) : 10000;
+    std::string checkpointFile = (runSolver && argc > 6) ? argv[6] : "";
+    double checkpointSeconds = (runSolver && argc > 7) ? std::atof(argv[7]) : 60.0;
+
+    std::vector<Puzzle> puzzles;
+    if (!loadPuzzleFile(argv[2], puzzles)) {
+        return 1;
+    }
+
+    for (const Puzzle& puzzle : puzzles) {
+        std::cout << "=== Puzzle at line " << puzzle.lineNumber << " (" << puzzle.N << "x" << puzzle.N << ") ===\n";
+        SudokuSolver solver(puzzle.N);
+        solver.loadBoard(puzzle.board);
+        printTreeSizeEstimate(solver, numProbes, numThreads);
+
+        if (runSolver) {
+            solver.setProgressReporting(true, 1.0);
+            if (!checkpointFile.empty()) {
+                // One checkpoint per puzzle of the file
+                std::string path = checkpointFile;
+                if (puzzles.size() > 1) {
+                    path += "." + std::to_string(puzzle.lineNumber);
+                }
+                solver.setCheckpointing(path, checkpointSeconds);
+            }
+            solver.solveParallelOptimized(numThreads, partitionDepth);
+            if (!solver.isComplete()) {
+                std::cout << "Stopped early; solutions so far: " << solver.getNumSolutions() << "\n";
+                return 2;
+            }
+            std::cout << "Solutions found: " << solver.getNumSolutions() << "\n";
+            std::cout << "Time: " << std::fixed << std::setprecision(2) << solver.getRunningTime() << " ms\n";
+            std::cout << std::defaultfloat;
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+// Race a portfolio of search configurations on every puzzle of a file and
+// report which configuration answered first
+// Usage: sudoku_solver portfolio <puzzleFile> [numConfigs] [maxSolutions] [outputCsv] [seed]
+int runPortfolioMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " portfolio <puzzleFile> [numConfigs] [maxSolutions] [outputCsv] [seed]\n";
+        return 1;
+    }
+    int numConfigs = (argc > 3) ? std::atoi(argv[3]) : 4;
+    long long maxSolutions = (argc > 4) ? std::atoll(argv[4]) : 1;
+    std::string outputFile = (argc > 5) ? argv[5] : "portfolio_results.csv";
+    uint64_t seed = (argc > 6) ? std::strtoull(argv[6], nullptr, 10) : 1;
+
+    std::vector<Puzzle> puzzles;
+    if (!loadPuzzleFile(argv[2], puzzles)) {
+        return 1;
+    }
+    std::vector<SearchConfig> configs = defaultPortfolio(numConfigs, seed);
+
+    std::cout << "=== Portfolio Solve ===\n";
+    std::cout << "Puzzles: " << puzzles.size() << ", Solution limit: " << maxSolutions << "\n";
+    std::cout << "Configurations:";
+    for (const SearchConfig& config : configs) {
+        std::cout << " " << config.name << "(" << config.seed << ")";
+    }
+    std::cout << "\n\n";
+
+    std::ofstream csvFile(outputFile);
+    if (!csvFile.is_open()) {
+        std::cerr << "Error: Could not create " << outputFile << "\n";
+        return 1;
+    }
+    csvFile << "Line,Board Size,Winner,Seed,Solutions,Time (ms)\n";
+
+    std::vector<int> wins(configs.size(), 0);
+    std::vector<double> times;
+    for (const Puzzle& puzzle : puzzles) {
+        SudokuSolver solver(puzzle.N);
+        solver.loadBoard(puzzle.board);
+        solver.solvePortfolio(configs, maxSolutions);
+        int winner = solver.getPortfolioWinner();
+        if (winner < 0) {
+            std::cerr << "Error: No configuration finished on the puzzle at line " << puzzle.lineNumber << "\n";
+            return 1;
+        }
+        wins[winner]++;
+        times.push_back(solver.getRunningTime());
+        csvFile << puzzle.lineNumber << ","
+                << puzzle.N << ","
+                << configs[winner].name << ","
+                << configs[winner].seed << ","
+                << solver.getNumSolutions() << ","
+                << std::fixed << std::setprecision(3) << solver.getRunningTime() << "\n";
+    }
+
+    std::cout << "Wins per configuration:\n";
+    for (size_t i = 0; i < configs.size(); ++i) {
+        std::cout << "  " << std::left << std::setw(22) << configs[i].name << std::right << wins[i] << "\n";
+    }
+    std::sort(times.begin(), times.end());
+    std::cout << "\nTime (ms) p50/p99/max: " << std::fixed << std::setprecision(3)
+              << percentile(times, 50.0) << "/" << percentile(times, 99.0) << "/"
+              << (times.empty() ? 0.0 : times.back()) << "\n";
+    std::cout << "Results saved to " << outputFile << "\n";
+    return 0;
+}
+
+// Run every configuration on generated puzzles (completed grids from GridGenerator
+// with emptyPercent of their cells cleared) and print p50/p99 times. Searches that
+// give up at their node limit count with the time they took, as a lower bound.
+int compareSearchConfigs(int N, int count, int emptyPercent, long long maxSolutions, uint64_t seed,
+                         const std::vector<SearchConfig>& configs, const std::string& outputFile) {
+    std::ofstream csvFile(outputFile);
+    if (!csvFile.is_open()) {
+        std::cerr << "Error: Could not create " << outputFile << "\n";
+        return 1;
+    }
+    csvFile << "Puzzle,Configuration,Solved,Solutions,Restarts,Nodes,Time (ms)\n";
+
+    GridGenerator generator(N, seed);
+    SplitMix64 rng(seed);
+    std::vector<std::vector<double>> times(configs.size());
+    std::vector<std::vector<double>> nodes(configs.size());
+    std::vector<long long> totalRestarts(configs.size(), 0);
+    std::vector<int> numGaveUp(configs.size(), 0);
+    std::vector<int> cells(N * N);
+    for (int i = 0; i < count; ++i) {
+        std::vector<int> board;
+        if (!generator.generate(board, i)) {
+            std::cerr << "Error: Could not generate grid " << i << "\n";
+            return 1;
+        }
+        for (int cell = 0; cell < N * N; ++cell) {
+            cells[cell] = cell;
+        }
+        for (int cell = N * N - 1; cell > 0; --cell) {
+            std::swap(cells[cell], cells[rng.below(cell + 1)]);
+        }
+        for (int k = 0; k < N * N * emptyPercent / 100; ++k) {
+            board[cells[k]] = 0;
+        }
+
+        SudokuSolver solver(N);
+        solver.loadBoard(board);
+        solver.setCollectStats(true);
+        long long expected = -1;  // Answer of the first configuration that finished
+        for (size_t c = 0; c < configs.size(); ++c) {
+            solver.solveFirst(configs[c], maxSolutions);
+            bool solved = !solver.queryGaveUp();
+            if (solved) {
+                if (solver.getNumSolutions() < 1 || (expected >= 0 && solver.getNumSolutions() != expected)) {
+                    std::cerr << "Error: " << configs[c].name << " found " << solver.getNumSolutions()
+                              << " solutions for puzzle " << i << "\n";
+                    return 1;
+                }
+                expected = solver.getNumSolutions();
+            }
+            long long searchNodes = solver.getStats().total().nodesVisited;
+            times[c].push_back(solver.getRunningTime());
+            nodes[c].push_back(static_cast<double>(searchNodes));
+            totalRestarts[c] += solver.getNumRestarts();
+            numGaveUp[c] += solved ? 0 : 1;
+            csvFile << i << "," << configs[c].name << "," << (solved ? "yes" : "no") << ","
+                    << solver.getNumSolutions() << "," << solver.getNumRestarts() << "," << searchNodes << ","
+                    << std::fixed << std::setprecision(3) << solver.getRunningTime() << "\n";
+        }
+    }
+
+    std::cout << std::left << std::setw(28) << "Configuration" << std::right << std::setw(12) << "p50 ms"
+              << std::setw(12) << "p99 ms" << std::setw(12) << "max ms" << std::setw(14) << "mean nodes"
+              << std::setw(12) << "restarts" << std::setw(10) << "gave up" << "\n";
+    for (size_t c = 0; c < configs.size(); ++c) {
+        Distribution dist = summarize(times[c]);
+        std::cout << std::left << std::setw(28) << configs[c].name << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(12) << dist.median << std::setw(12) << dist.p99
+                  << std::setw(12) << dist.max << std::setprecision(0) << std::setw(14) << mean(nodes[c])
+                  << std::setw(12) << totalRestarts[c] << std::setw(10) << numGaveUp[c] << "\n";
+    }
+    std::cout << "Results saved to " << outputFile << "\n";
+    return 0;
+}
+
+// Compare restart schedules of the first-solution search on generated puzzles
+// Usage: sudoku_solver restarts [N] [count] [emptyPercent] [restartUnit] [nodeLimit] [seed] [outputCsv]
+int runRestartMode(int argc, char* argv[]) {
+    int N = (argc > 2) ? std::atoi(argv[2]) : 25;
+    int count = (argc > 3) ? std::atoi(argv[3]) : 100;
+    int emptyPercent = (argc > 4) ? std::atoi(argv[4]) : 70;
+    long long restartUnit = (argc > 5) ? std::atoll(argv[5]) : 0;
+    long long nodeLimit = (argc > 6) ? std::atoll(argv[6]) : 1000000;
+    uint64_t seed = (argc > 7) ? std::strtoull(argv[7], nullptr, 10) : 1;
+    std::string outputFile = (argc > 8) ? argv[8] : "restart_results.csv";
+
+    std::vector<SearchConfig> configs;
+    configs.push_back(SearchConfig("mrv-ascending", false, CELL_MRV, VALUE_ASCENDING, seed));
+    configs.push_back(SearchConfig("mrv-random", false, CELL_MRV, VALUE_RANDOM, seed));
+    configs.push_back(SearchConfig("mrv-random-luby", false, CELL_MRV, VALUE_RANDOM, seed,
+                                   RESTART_LUBY, restartUnit));
+    configs.push_back(SearchConfig("mrv-random-geometric", false, CELL_MRV, VALUE_RANDOM, seed,
+                                   RESTART_GEOMETRIC, restartUnit));
+    for (SearchConfig& config : configs) {
+        config.nodeLimit = nodeLimit;
+    }
+
+    std::cout << "=== Restart Schedules for " << N << "x" << N << " ===\n";
+    std::cout << "Puzzles: " << count << ", Empty cells: " << emptyPercent << "%, Restart unit: "
+              << (restartUnit > 0 ? restartUnit : 4LL * N * N) << " nodes, Node limit: " << nodeLimit
+              << ", Seed: " << seed << "\n\n";
+    return compareSearchConfigs(N, count, emptyPercent, 1, seed, configs, outputFile);
+}
+
+// Compare value orders of the first-solution search on generated puzzles
+// Usage: sudoku_solver values [N] [count] [emptyPercent] [maxSolutions] [nodeLimit] [seed] [outputCsv]
+int runValueOrderMode(int argc, char* argv[]) {
+    int N = (argc > 2) ? std::atoi(argv[2]) : 25;
+    int count = (argc > 3) ? std::atoi(argv[3]) : 50;
+    int emptyPercent = (argc > 4) ? std::atoi(argv[4]) : 65;
+    long long maxSolutions = (argc > 5) ? std::atoll(argv[5]) : 1;
+    long long nodeLimit = (argc > 6) ? std::atoll(argv[6]) : 1000000;
+    uint64_t seed = (argc > 7) ? std::strtoull(argv[7], nullptr, 10) : 1;
+    std::string outputFile = (argc > 8) ? argv[8] : "value_order_results.csv";
+
+    std::vector<SearchConfig> configs;
+    configs.push_back(SearchConfig("mrv-ascending", false, CELL_MRV, VALUE_ASCENDING, seed));
+    configs.push_back(SearchConfig("mrv-least-constraining", false, CELL_MRV, VALUE_LEAST_CONSTRAINING, seed));
+    configs.push_back(SearchConfig("mrv-least-placed", false, CELL_MRV, VALUE_LEAST_PLACED, seed));
+    for (SearchConfig& config : configs) {
+        config.nodeLimit = nodeLimit;
+    }
+
+    std::cout << "=== Value Orders for " << N << "x" << N << " ===\n";
+    std::cout << "Puzzles: " << count << ", Empty cells: " << emptyPercent << "%, Solution limit: "
+              << maxSolutions << ", Node limit: " << nodeLimit << ", Seed: " << seed << "\n\n";
+    return compareSearchConfigs(N, count, emptyPercent, maxSolutions, seed, configs, outputFile);
+}
+
+// Count all completions using the symmetries the givens leave intact
+// Usage: sudoku_solver symmetry <puzzleFile> [numThreads] [frontierDepth]
+//        sudoku_solver symmetry empty <N> [numThreads] [frontierDepth]
+int runSymmetryMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " symmetry <puzzleFile> [numThreads] [frontierDepth]\n"
+                  << "       " << argv[0] << " symmetry empty <N> [numThreads] [frontierDepth]\n";
+        return 1;
+    }
+    bool empty = std::string(argv[2]) == "empty";
+    int firstOption = empty ? 4 : 3;
+    int numThreads = (argc > firstOption) ? std::atoi(argv[firstOption]) : 4;
+    int frontierDepth = (argc > firstOption + 1) ? std::atoi(argv[firstOption + 1]) : 3;
+
+    std::vector<Puzzle> puzzles;
+    if (empty) {
+        Puzzle puzzle;
+        puzzle.N = (argc > 3) ? std::atoi(argv[3]) : 9;
+        puzzle.board.assign(puzzle.N * puzzle.N, 0);
+        puzzle.lineNumber = 0;
+        puzzles.push_back(puzzle);
+    } else if (!loadPuzzleFile(argv[2], puzzles)) {
+        return 1;
+    }
+
+    for (const Puzzle& puzzle : puzzles) {
+        if (empty) {
+            std::cout << "=== Empty " << puzzle.N << "x" << puzzle.N << " grid ===\n";
+        } else {
+            std::cout << "=== Puzzle at line " << puzzle.lineNumber << " (" << puzzle.N << "x" << puzzle.N << ") ===\n";
+        }
+        SymmetryCounter counter(puzzle.N, numThreads);
+        counter.setFrontierDepth(frontierDepth);
+        SymmetryCount result;
+        if (!counter.count(puzzle.board, result)) {
+            return 1;
+        }
+        std::cout << "Method: " << symmetryMethodName(result.method)
+                  << " (unused digits: " << result.unusedDigits
+                  << ", band/stack symmetries: " << result.geometricSymmetries << ")\n";
+        std::cout << "Representatives: " << uint128ToString(result.representatives)
+                  << ", Orbit size: " << uint128ToString(result.orbitSize) << "\n";
+        std::cout << "Solutions: " << uint128ToString(result.solutions) << "\n";
+        std::cout << "Nodes: " << result.nodes << "\n";
+        std::cout << "Time: " << std::fixed << std::setprecision(2) << result.timeMs << " ms\n\n";
+        std::cout << std::defaultfloat;
+    }
+    return 0;
+}
+
+// Count all completions with the row-by-row DP over column and block masks. Empty
+// boards whose size is not a perfect square use rectangular blocks (6 -> 2x3); puzzle
+// lines choose theirs with a "<rows>x<cols>" prefix (e.g. "2x3 1 . . 4 ...").
+// Usage: sudoku_solver dpcount <puzzleFile> [numThreads] [stateLimit]
+//        sudoku_solver dpcount empty <N> [numThreads] [stateLimit]
+int runRowDpMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " dpcount <puzzleFile> [numThreads] [stateLimit]\n"
+                  << "       " << argv[0] << " dpcount empty <N> [numThreads] [stateLimit]\n";
+        return 1;
+    }
+    bool empty = std::string(argv[2]) == "empty";
+    int firstOption = empty ? 4 : 3;
+    int numThreads = (argc > firstOption) ? std::atoi(argv[firstOption]) : 4;
+    long long stateLimit = (argc > firstOption + 1) ? std::atoll(argv[firstOption + 1]) : 20000000;
+
+    std::vector<Puzzle> puzzles;
+    if (empty) {
+        Puzzle puzzle;
+        puzzle.N = (argc > 3) ? std::atoi(argv[3]) : 9;
+        puzzle.board.assign(puzzle.N * puzzle.N, 0);
+        puzzle.lineNumber = 0;
+        puzzles.push_back(puzzle);
+    } else if (!loadPuzzleFile(argv[2], puzzles, true)) {
+        return 1;
+    }
+
+    for (const Puzzle& puzzle : puzzles) {
+        RowDpCounter counter(puzzle.N, numThreads);
+        counter.setStateLimit(stateLimit);
+        int blockRows = puzzle.blockRows;
+        if (blockRows == 0) {
+            blockRows = static_cast<int>(std::sqrt(puzzle.N));
+            while (blockRows > 1 && puzzle.N % blockRows != 0) {
+                --blockRows;
+            }
+        }
+        counter.setBlockShape(blockRows, puzzle.N / blockRows);
+        if (empty) {
+            std::cout << "=== Empty " << puzzle.N << "x" << puzzle.N << " grid (" << blockRows << "x"
+                      << puzzle.N / blockRows << " blocks) ===\n";
+        } else {
+            std::cout << "=== Puzzle at line " << puzzle.lineNumber << " (" << puzzle.N << "x" << puzzle.N << ", "
+                      << blockRows << "x" << puzzle.N / blockRows << " blocks) ===\n";
+        }
+        RowDpCount result;
+        if (!counter.count(puzzle.board, result)) {
+            return 1;
+        }
+        std::cout << "Solutions: " << uint128ToString(result.solutions) << "\n";
+        std::cout << "States: " << result.totalStates << " (largest row: " << result.maxStates
+                  << "), Row fillings: " << result.rowFillings << "\n";
+        std::cout << "Time: " << std::fixed << std::setprecision(2) << result.timeMs << " ms\n\n";
+        std::cout << std::defaultfloat;
+    }
+    return 0;
+}
+
+// Count every puzzle of a file with a coordinator and worker processes on this
+// machine. The first failingWorkers workers exit on their first lease, to show that
+// their leases are reassigned. The coordinator listens on loopback; given a
+// bindAddress it also accepts workers started elsewhere ("worker <host> <port>").
+// Usage: sudoku_solver distributed <puzzleFile> [numWorkers] [partitionDepth] [chunkSize]
+//                                  [threadsPerWorker] [failingWorkers] [port] [leaseSeconds]
+//                                  [bindAddress]
+int runDistributedMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " distributed <puzzleFile> [numWorkers] [partitionDepth] [chunkSize]"
+                  << " [threadsPerWorker] [failingWorkers] [port] [leaseSeconds] [bindAddress]\n";
+        return 1;
+    }
+    int numWorkers = (argc > 3) ? std::atoi(argv[3]) : 4;
+    int partitionDepth = (argc > 4) ? std::atoi(argv[4]) : 3;
+    int chunkSize = (argc > 5) ? std::atoi(argv[5]) : 8;
+    int threadsPerWorker = (argc > 6) ? std::atoi(argv[6]) : 1;
+    int failingWorkers = (argc > 7) ? std::atoi(argv[7]) : 0;
+    int port = (argc > 8) ? std::atoi(argv[8]) : 0;
+    double leaseSeconds = (argc > 9) ? std::atof(argv[9]) : 600.0;
+    std::string bindAddress = (argc > 10) ? argv[10] : "";
+
+    std::vector<Puzzle> puzzles;
+    if (!loadPuzzleFile(argv[2], puzzles)) {
+        return 1;
+    }
+
+    for (const Puzzle& puzzle : puzzles) {
+        std::cout << "=== Puzzle at line " << puzzle.lineNumber << " (" << puzzle.N << "x" << puzzle.N << ") ===\n";
+        Coordinator coordinator(puzzle.N, puzzle.board);
+        coordinator.setPartitionDepth(partitionDepth);
+        coordinator.setChunkSize(chunkSize);
+        coordinator.setLeaseTimeout(leaseSeconds);
+        if (!coordinator.listen(port, bindAddress)) {
+            return 1;
+        }
+        std::cout << "Coordinator on port " << coordinator.getPort() << ", " << numWorkers << " local workers ("
+                  << failingWorkers << " failing)\n";
+
+        std::vector<int> pids;
+        for (int i = 0; i < numWorkers; ++i) {
+            int failAfter = (i < failingWorkers) ? 1 : 0;
+            pids.push_back(spawnLocalWorker(argv[0], coordinator.getPort(), threadsPerWorker, failAfter));
+        }
+
+        DistributedStats stats;
+        bool complete = coordinator.run(stats);
+        for (int pid : pids) {
+            waitForWorker(pid);
+        }
+
+        std::cout << "Subproblems: " << stats.numSubproblems << ", Leases: " << stats.numLeases
+                  << " (granted " << stats.leasesGranted << ", reassigned " << stats.reassignedLeases
+                  << ", duplicate results " << stats.duplicateResults << ")\n";
+        std::cout << "Workers: " << stats.workersSeen << " connected, " << stats.workersLost << " lost\n";
+        if (!complete) {
+            std::cout << "Incomplete; solutions counted: " << stats.solutions << "\n";
+            return 2;
+        }
+        std::cout << "Solutions found: " << stats.solutions << "\n";
+        std::cout << "Time: " << std::fixed << std::setprecision(2) << stats.timeMs << " ms\n\n";
+        std::cout << std::defaultfloat;
+    }
+    return 0;
+}
+
+// Worker process of a distributed count
+// Usage: sudoku_solver worker <host> <port> [numThreads] [failAfterLeases]
+int runWorkerMode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " worker <host> <port> [numThreads] [failAfterLeases]\n";
+        return 1;
+    }
+    int numThreads = (argc > 4) ? std::atoi(argv[4]) : 1;
+    int failAfterLeases = (argc > 5) ? std::atoi(argv[5]) : 0;
+    return runWorker(argv[2], std::atoi(argv[3]), numThreads, failAfterLeases) ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "generate") {
+        return runGenerateMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "rate") {
+        return runRateMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "estimate") {
+        return runCountMode(argc, argv, false);
+    }
+    if (argc > 1 && std::string(argv[1]) == "count") {
+        return runCountMode(argc, argv, true);
+    }
+    if (argc > 1 && std::string(argv[1]) == "portfolio") {
+        return runPortfolioMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "restarts") {
+        return runRestartMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "values") {
+        return runValueOrderMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "symmetry") {
+        return runSymmetryMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "dpcount") {
+        return runRowDpMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "distributed") {
+        return runDistributedMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "worker") {
+        return runWorkerMode(argc, argv);
+    }
+
     std::cout << "OpenMP Parallel Sudoku Solver - Optimized Version\n";
     std::cout << "==================================================\n\n";
 
@@ -123,12 +731,8 @@ int main(int argc, char* argv[]) {
         runComprehensiveBenchmark(9, board);
     }
     else if (boardSize == 16) {
-        // For demo purposes, using empty 16x16 board would take too long
-        // In real scenario, you'd have a partially filled 16x16 board
-        std::cout << "Note: Full 16x16 benchmark would take too long for demo.\n";
-        std::cout << "Using 9x9 board for demonstration instead.\n\n";
-        board = getTestBoard9x9();
-        runComprehensiveBenchmark(9, board);
+        board = getTestBoard16x16();
+        runComprehensiveBenchmark(16, board);
     }
     else {
         std::cout << "Using standard 9x9 board.\n\n";
@@ -0,0 +1,409 @@
+#include "sudoku_solver.h"
+#include "bench_stats.h"
+#include "puzzle_io.h"
+#include "candidate_kernels.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#ifndef SUDOKU_CORPUS_PATH
+#define SUDOKU_CORPUS_PATH "benchmarks/corpus.txt"
+#endif
+
+// Keep a value alive so the compiler cannot drop the computation producing it
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+// Command-line options
+struct MicroOptions {
+    int repetitions;       // Timed repetitions per benchmark
+    double minRepMs;       // Minimum duration of one repetition
+    std::string filter;    // Only run benchmarks whose name contains this
+    std::string corpusPath;
+    std::string csvPath;
+
+    MicroOptions()
+        : repetitions(15), minRepMs(10.0), corpusPath(SUDOKU_CORPUS_PATH),
+          csvPath("micro_benchmarks.csv") {}
+};
+
+// ns/op of one benchmark over all repetitions
+struct MicroResult {
+    std::string name;
+    int N;
+    long long opsPerRep;
+    std::vector<double> nsPerOp;  // One entry per repetition
+};
+
+// Time fn(ops) where fn performs ops operations. The batch size is doubled until a
+// batch takes at least minRepMs, then one warmup and the timed repetitions follow.
+// Benchmarks not matching the filter are skipped (returns nullptr).
+template <typename Fn>
+MicroResult* runMicro(const MicroOptions& options, std::vector<MicroResult>& results,
+                      const std::string& name, int N, Fn fn) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+        return nullptr;
+    }
+    using Clock = std::chrono::steady_clock;
+    auto timeBatch = [&](long long ops) {
+        auto start = Clock::now();
+        fn(ops);
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        return elapsed.count();
+    };
+
+    long long ops = 1;
+    while (timeBatch(ops) < options.minRepMs * 1e6 && ops < (1ll << 40)) {
+        ops *= 2;
+    }
+    timeBatch(ops);
+
+    MicroResult result;
+    result.name = name;
+    result.N = N;
+    result.opsPerRep = ops;
+    for (int rep = 0; rep < options.repetitions; ++rep) {
+        result.nsPerOp.push_back(timeBatch(ops) / ops);
+    }
+    results.push_back(result);
+    return &results.back();
+}
+
+// Random legal state: a prefix of a valid grid placed into the masks
+static BitMaskState makeState(int N, int blockSize, SplitMix64& rng, std::vector<int>& board) {
+    BitMaskState state(N);
+    board.assign(N * N, 0);
+    for (int cell = 0; cell < N * N; ++cell) {
+        int row = cell / N;
+        int col = cell % N;
+        // Latin pattern shifted per block row, filled with ~40% probability
+        int value = (row * blockSize + row / blockSize + col) % N + 1;
+        if (rng.below(10) < 4) {
+            board[cell] = value;
+            state.set(N, blockSize, row, col, value);
+        }
+    }
+    return state;
+}
+
+// Per-size kernels on the bitmask state
+static void benchmarkKernels(const MicroOptions& options, int N, std::vector<MicroResult>& results) {
+    int blockSize = 1;
+    while ((blockSize + 1) * (blockSize + 1) <= N) {
+        ++blockSize;
+    }
+    SplitMix64 rng(static_cast<uint64_t>(N) * 7919);
+    std::vector<int> board;
+    BitMaskState state = makeState(N, blockSize, rng, board);
+
+    // Random queries, precomputed so the loop measures the kernel only
+    const int numQueries = 4096;
+    std::vector<int> rows(numQueries), cols(numQueries), values(numQueries);
+    for (int i = 0; i < numQueries; ++i) {
+        rows[i] = rng.below(N);
+        cols[i] = rng.below(N);
+        values[i] = 1 + rng.below(N);
+    }
+
+    runMicro(options, results, "BitMaskState::canPlace", N, [&](long long ops) {
+        int placeable = 0;
+        for (long long i = 0; i < ops; ++i) {
+            int q = static_cast<int>(i & (numQueries - 1));
+            placeable += state.canPlace(N, blockSize, rows[q], cols[q], values[q]);
+        }
+        doNotOptimize(placeable);
+    });
+
+    runMicro(options, results, "BitMaskState::set+unset", N, [&](long long ops) {
+        for (long long i = 0; i < ops; ++i) {
+            int q = static_cast<int>(i & (numQueries - 1));
+            state.set(N, blockSize, rows[q], cols[q], values[q]);
+            state.unset(N, blockSize, rows[q], cols[q], values[q]);
+        }
+        doNotOptimize(state.rowMask[0]);
+    });
+    // set+unset clears bits that were set before; rebuild the state
+    state = makeState(N, blockSize, rng, board);
+
+    runMicro(options, results, "candidates+enumerate", N, [&](long long ops) {
+        int sum = 0;
+        for (long long i = 0; i < ops; ++i) {
+            int q = static_cast<int>(i & (numQueries - 1));
+            uint64_t mask = state.candidates(N, blockSize, rows[q], cols[q]);
+            while (mask) {
+                sum += lowestBit64(mask);
+                mask &= mask - 1;
+            }
+        }
+        doNotOptimize(sum);
+    });
+
+    runMicro(options, results, "candidates canPlace loop", N, [&](long long ops) {
+        int sum = 0;
+        for (long long i = 0; i < ops; ++i) {
+            int q = static_cast<int>(i & (numQueries - 1));
+            for (int value = 1; value <= N; ++value) {
+                if (state.canPlace(N, blockSize, rows[q], cols[q], value)) {
+                    sum += value;
+                }
+            }
+        }
+        doNotOptimize(sum);
+    });
+
+    // Candidate masks of all cells in one pass and their classification by
+    // candidate count (one op = one board), for every kernel path this CPU has
+    std::vector<uint64_t> allCandidates(N * N);
+    std::vector<int> singles(N * N);
+    for (int path = KERNEL_SCALAR; path < NUM_KERNEL_PATHS; ++path) {
+        const KernelTable* kernels = getKernelTable(static_cast<KernelPath>(path));
+        if (!kernels) {
+            continue;
+        }
+        runMicro(options, results, std::string("all-cell candidates (") + kernels->name + ")", N, [&](long long ops) {
+            for (long long i = 0; i < ops; ++i) {
+                kernels->computeAllCandidates(board.data(), N, blockSize, state.rowMask.data(), state.colMask.data(),
+                                              state.blockMask.data(), allCandidates.data());
+                doNotOptimize(allCandidates.data());
+            }
+        });
+        kernels->computeAllCandidates(board.data(), N, blockSize, state.rowMask.data(), state.colMask.data(),
+                                      state.blockMask.data(), allCandidates.data());
+        runMicro(options, results, std::string("candidate scan (") + kernels->name + ")", N, [&](long long ops) {
+            CandidateScan scan;
+            for (long long i = 0; i < ops; ++i) {
+                kernels->scanCandidates(allCandidates.data(), board.data(), N * N, singles.data(), scan);
+                doNotOptimize(scan);
+            }
+        });
+    }
+
+    // Hidden singles of all 3N units (one op = one board)
+    std::vector<uint64_t> once(3 * N), seen(3 * N);
+    runMicro(options, results, "hidden singles (scalar count)", N, [&](long long ops) {
+        for (long long i = 0; i < ops; ++i) {
+            findHiddenSinglesScalar(allCandidates.data(), N, blockSize, once.data(), seen.data());
+            doNotOptimize(once.data());
+        }
+    });
+    runMicro(options, results, "hidden singles (bit-parallel)", N, [&](long long ops) {
+        for (long long i = 0; i < ops; ++i) {
+            findHiddenSingles(allCandidates.data(), N, blockSize, once.data(), seen.data());
+            doNotOptimize(once.data());
+        }
+    });
+
+    Subproblem subproblem(N);
+    subproblem.board = board;
+    subproblem.state = state;
+    runMicro(options, results, "Subproblem copy", N, [&](long long ops) {
+        for (long long i = 0; i < ops; ++i) {
+            Subproblem copy = subproblem;
+            doNotOptimize(copy.board.data());
+        }
+    });
+}
+
+// First-solution and uniqueness queries: bitmask search against clause learning,
+// and the value orders of the MRV search
+static void benchmarkQueries(const MicroOptions& options, const CorpusEntry& entry,
+                             std::vector<MicroResult>& results) {
+    SudokuSolver solver(entry.puzzle.N);
+    solver.loadBoard(entry.puzzle.board);
+    for (SearchEngine engine : {SEARCH_ROW_MAJOR, SEARCH_CDCL}) {
+        std::string engineName = (engine == SEARCH_CDCL) ? "cdcl" : "row-major";
+        for (long long limit : {1ll, 2ll}) {
+            std::string query = (limit == 1) ? "first solution " : "uniqueness ";
+            runMicro(options, results, query + engineName + " (" + entry.name + ")", entry.puzzle.N,
+                     [&](long long ops) {
+                solver.setSearchEngine(engine);
+                long long solutions = 0;
+                for (long long i = 0; i < ops; ++i) {
+                    solver.solveFirst(limit);
+                    solutions += solver.getNumSolutions();
+                }
+                doNotOptimize(solutions);
+            });
+        }
+    }
+    solver.setSearchEngine(SEARCH_ROW_MAJOR);
+
+    // MRV search with each value order
+    const ValueOrder orders[] = {VALUE_ASCENDING, VALUE_LEAST_CONSTRAINING, VALUE_LEAST_PLACED};
+    const char* orderNames[] = {"ascending", "least-constraining", "least-placed"};
+    for (int order = 0; order < 3; ++order) {
+        SearchConfig config(std::string("mrv-") + orderNames[order], false, CELL_MRV, orders[order], 1);
+        for (long long limit : {1ll, 2ll}) {
+            std::string query = (limit == 1) ? "first solution " : "uniqueness ";
+            runMicro(options, results, query + config.name + " (" + entry.name + ")", entry.puzzle.N,
+                     [&](long long ops) {
+                long long solutions = 0;
+                for (long long i = 0; i < ops; ++i) {
+                    solver.solveFirst(config, limit);
+                    solutions += solver.getNumSolutions();
+                }
+                doNotOptimize(solutions);
+            });
+        }
+    }
+}
+
+// Frontier generation and search cost on a corpus puzzle
+static void benchmarkSearch(const MicroOptions& options, const CorpusEntry& entry,
+                            std::vector<MicroResult>& results) {
+    int N = entry.puzzle.N;
+    SudokuSolver solver(N);
+    solver.loadBoard(entry.puzzle.board);
+
+    for (int depth = 1; depth <= 3; ++depth) {
+        std::vector<Subproblem> frontier;
+        solver.generateSubproblems(depth, frontier);
+        std::string name = "frontier depth " + std::to_string(depth) + " (" + entry.name + ", "
+                         + std::to_string(frontier.size()) + " subproblems)";
+        // One op = one subproblem produced
+        MicroResult* result = runMicro(options, results, name, N, [&](long long ops) {
+            for (long long i = 0; i < ops; ++i) {
+                std::vector<Subproblem> subproblems;
+                solver.generateSubproblems(depth, subproblems);
+                doNotOptimize(subproblems.data());
+            }
+        });
+        if (result) {
+            for (double& ns : result->nsPerOp) {
+                ns /= std::max<size_t>(1, frontier.size());
+            }
+        }
+    }
+
+    std::vector<Subproblem> frontier;
+    solver.generateSubproblems(1, frontier);
+
+    // Whole solve with each subproblem search (one op = one puzzle)
+    for (SearchEngine engine : {SEARCH_ROW_MAJOR, SEARCH_PROPAGATION, SEARCH_CDCL}) {
+        std::string engineName = (engine == SEARCH_PROPAGATION) ? "propagation"
+                               : (engine == SEARCH_CDCL) ? "cdcl" : "row-major";
+        runMicro(options, results, "solve " + engineName + " (" + entry.name + ")", N, [&](long long ops) {
+            solver.setSearchEngine(engine);
+            long long solutions = 0;
+            for (long long i = 0; i < ops; ++i) {
+                for (const Subproblem& subproblem : frontier) {
+                    solutions += solver.solveSubproblem(subproblem);
+                }
+            }
+            doNotOptimize(solutions);
+        });
+    }
+    solver.setSearchEngine(SEARCH_ROW_MAJOR);
+
+    MicroResult* result = runMicro(options, results, "search node (" + entry.name + ")", N, [&](long long ops) {
+        long long solutions = 0;
+        for (long long i = 0; i < ops; ++i) {
+            for (const Subproblem& subproblem : frontier) {
+                solutions += solver.solveSubproblem(subproblem);
+            }
+        }
+        doNotOptimize(solutions);
+    });
+    if (!result) {
+        return;
+    }
+
+    // Nodes of the whole search, counted once with statistics enabled
+    solver.setCollectStats(true);
+    solver.solveParallelOptimized(1, 1);
+    long long nodes = std::max(1ll, solver.getStats().total().nodesVisited);
+    for (double& ns : result->nsPerOp) {
+        ns /= nodes;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    MicroOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--reps" && i + 1 < argc) {
+            options.repetitions = std::max(2, std::atoi(argv[++i]));
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.minRepMs = std::atof(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--corpus" && i + 1 < argc) {
+            options.corpusPath = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            options.csvPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--reps N] [--min-time MS] [--filter TEXT] [--corpus FILE] [--csv FILE]\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Solver Kernel Micro-Benchmarks\n";
+    std::cout << "==============================\n";
+    std::cout << "Repetitions: " << options.repetitions << ", minimum " << options.minRepMs
+              << " ms per repetition\n";
+    std::cout << "Kernel path: " << candidateKernelName() << " (available:";
+    for (int path = KERNEL_SCALAR; path < NUM_KERNEL_PATHS; ++path) {
+        if (const KernelTable* kernels = getKernelTable(static_cast<KernelPath>(path))) {
+            std::cout << " " << kernels->name;
+        }
+    }
+    std::cout << "; override with SUDOKU_KERNEL_PATH)\n\n";
+
+    std::vector<MicroResult> results;
+    for (int N : {9, 16, 25, 36}) {
+        benchmarkKernels(options, N, results);
+    }
+
+    // Search kernels on the "hard" corpus puzzle of each size
+    std::vector<CorpusEntry> corpus;
+    if (loadCorpusFile(options.corpusPath, corpus)) {
+        for (const CorpusEntry& entry : corpus) {
+            if (entry.category == "hard" && entry.name.find("generated") == std::string::npos) {
+                benchmarkSearch(options, entry, results);
+            }
+            if ((entry.category == "hard" || entry.category == "pathological")
+                && entry.name.find("generated") == std::string::npos) {
+                benchmarkQueries(options, entry, results);
+            }
+        }
+    }
+
+    std::cout << std::left << std::setw(66) << "Benchmark" << std::right << std::setw(4) << "N"
+              << std::setw(16) << "median ns" << std::setw(16) << "min ns" << std::setw(16) << "p95 ns"
+              << std::setw(10) << "sd %" << "\n";
+    std::ofstream csvFile(options.csvPath);
+    csvFile << "Benchmark,N,Ops per Repetition,Repetitions,Median (ns/op),Min (ns/op),P95 (ns/op),Std Dev (ns/op)\n";
+
+    for (const MicroResult& result : results) {
+        std::vector<double> sorted = result.nsPerOp;
+        std::sort(sorted.begin(), sorted.end());
+        double medianNs = percentile(sorted, 50.0);
+        double deviation = stddev(sorted);
+
+        std::cout << std::left << std::setw(66) << result.name << std::right << std::setw(4) << result.N
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(16) << medianNs
+                  << std::setw(16) << sorted.front()
+                  << std::setw(16) << percentile(sorted, 95.0)
+                  << std::setw(10) << std::setprecision(1) << (medianNs > 0 ? 100.0 * deviation / medianNs : 0.0)
+                  << "\n";
+        csvFile << "\"" << result.name << "\"," << result.N << "," << result.opsPerRep << ","
+                << sorted.size() << "," << std::setprecision(3) << medianNs << "," << sorted.front() << ","
+                << percentile(sorted, 95.0) << "," << deviation << "\n";
+    }
+
+    std::cout << "\nResults saved to " << options.csvPath << "\n";
+    return 0;
+}
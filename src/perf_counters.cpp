@@ -0,0 +1,202 @@
+#include "perf_counters.h"
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Human-readable event name
+const char* perfEventName(int event) {
+    switch (event) {
+        case PERF_CYCLES: return "Cycles";
+        case PERF_INSTRUCTIONS: return "Instructions";
+        case PERF_L1D_MISSES: return "L1D Misses";
+        case PERF_LLC_MISSES: return "LLC Misses";
+        case PERF_BRANCH_MISSES: return "Branch Misses";
+    }
+    return "Unknown";
+}
+
+#ifdef __linux__
+
+// perf_event attributes of one event; the group starts disabled and is enabled by start()
+static perf_event_attr makeAttr(int event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                     | PERF_FORMAT_TOTAL_TIME_RUNNING | PERF_FORMAT_ID;
+
+    switch (event) {
+        case PERF_CYCLES:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            attr.disabled = 1;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D
+                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_LLC_MISSES:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PERF_BRANCH_MISSES:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+    return attr;
+}
+
+static int openEvent(perf_event_attr& attr, int groupFd) {
+    // pid = 0, cpu = -1: count the calling thread on any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+#endif
+
+// Constructor
+PerfCounterGroup::PerfCounterGroup() : leader(-1) {
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        fds[i] = -1;
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+    close();
+}
+
+// Open the counters for the calling thread
+bool PerfCounterGroup::open() {
+    close();
+#ifdef __linux__
+    perf_event_attr leaderAttr = makeAttr(PERF_CYCLES);
+    leader = openEvent(leaderAttr, -1);
+    if (leader < 0) {
+        return false;
+    }
+    fds[PERF_CYCLES] = leader;
+
+    // Events the PMU does not support are left out; the rest of the group still counts
+    for (int event = PERF_CYCLES + 1; event < NUM_PERF_EVENTS; ++event) {
+        perf_event_attr attr = makeAttr(event);
+        fds[event] = openEvent(attr, leader);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PerfCounterGroup::close() {
+#ifdef __linux__
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        if (fds[i] >= 0) {
+            ::close(fds[i]);
+        }
+        fds[i] = -1;
+    }
+#endif
+    leader = -1;
+}
+
+// Reset and start counting
+void PerfCounterGroup::start() {
+#ifdef __linux__
+    if (leader < 0) {
+        return;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+// Stop counting and read the values, scaled up if the group was multiplexed
+PerfCounts PerfCounterGroup::stop() {
+    PerfCounts counts;
+#ifdef __linux__
+    if (leader < 0) {
+        return counts;
+    }
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // Group read layout: nr, time_enabled, time_running, then {value, id} per event
+    uint64_t buffer[3 + 2 * NUM_PERF_EVENTS];
+    ssize_t bytes = read(leader, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        return counts;
+    }
+
+    uint64_t numEvents = buffer[0];
+    uint64_t timeEnabled = buffer[1];
+    uint64_t timeRunning = buffer[2];
+    if (timeRunning == 0) {
+        return counts;
+    }
+    double scale = static_cast<double>(timeEnabled) / timeRunning;
+
+    // Match values to events by id
+    for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+        if (fds[event] < 0) {
+            continue;
+        }
+        uint64_t id = 0;
+        if (ioctl(fds[event], PERF_EVENT_IOC_ID, &id) != 0) {
+            continue;
+        }
+        for (uint64_t i = 0; i < numEvents && i < NUM_PERF_EVENTS; ++i) {
+            if (buffer[3 + 2 * i + 1] == id) {
+                counts.values[event] = static_cast<long long>(buffer[3 + 2 * i] * scale);
+                break;
+            }
+        }
+    }
+#endif
+    return counts;
+}
+
+bool PerfCounterGroup::isOpen() const {
+    return leader >= 0;
+}
+
+// Probe once whether a cycles counter can be opened
+static std::string probeReason() {
+#ifdef __linux__
+    perf_event_attr attr = makeAttr(PERF_CYCLES);
+    int fd = openEvent(attr, -1);
+    if (fd >= 0) {
+        close(fd);
+        return "";
+    }
+    int error = errno;
+    std::string reason = std::string("perf_event_open failed: ") + std::strerror(error);
+    if (error == EACCES || error == EPERM) {
+        reason += " (check /proc/sys/kernel/perf_event_paranoid or container seccomp policy)";
+    } else if (error == ENOENT || error == EOPNOTSUPP) {
+        reason += " (no hardware PMU exposed, e.g. in a VM or container)";
+    }
+    return reason;
+#else
+    return "hardware counters are only supported on Linux";
+#endif
+}
+
+std::string perfUnavailableReason() {
+    static const std::string reason = probeReason();
+    return reason;
+}
+
+bool perfCountersAvailable() {
+    return perfUnavailableReason().empty();
+}
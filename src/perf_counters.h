@@ -0,0 +1,90 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <string>
+
+// Hardware events counted by PerfCounterGroup
+enum PerfEvent {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,      // L1 data cache read misses
+    PERF_LLC_MISSES,      // Last-level cache misses
+    PERF_BRANCH_MISSES,
+    NUM_PERF_EVENTS
+};
+
+// Human-readable event name
+const char* perfEventName(int event);
+
+// Counter values of one measured interval; -1 marks an event that was not counted
+struct PerfCounts {
+    long long values[NUM_PERF_EVENTS];
+
+    PerfCounts() {
+        for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+            values[i] = -1;
+        }
+    }
+
+    bool valid() const { return values[PERF_CYCLES] >= 0; }
+
+    void add(const PerfCounts& other) {
+        for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+            if (other.values[i] >= 0) {
+                values[i] = (values[i] < 0 ? 0 : values[i]) + other.values[i];
+            }
+        }
+    }
+
+    // Instructions per cycle (0 if not counted)
+    double ipc() const {
+        if (values[PERF_CYCLES] <= 0 || values[PERF_INSTRUCTIONS] < 0) {
+            return 0.0;
+        }
+        return static_cast<double>(values[PERF_INSTRUCTIONS]) / values[PERF_CYCLES];
+    }
+
+    // Events per thousand instructions (-1 if not counted)
+    double perKiloInstructions(int event) const {
+        if (values[event] < 0 || values[PERF_INSTRUCTIONS] <= 0) {
+            return -1.0;
+        }
+        return 1000.0 * values[event] / values[PERF_INSTRUCTIONS];
+    }
+};
+
+// Group of hardware counters for the calling thread (Linux perf_event_open).
+// Counts user-space events only, so it works with the default
+// perf_event_paranoid setting. When the events cannot be opened (other
+// platforms, containers, VMs without a PMU) open() returns false and stop()
+// returns counts marked as not counted.
+class PerfCounterGroup {
+private:
+    int fds[NUM_PERF_EVENTS];  // -1 for events that could not be opened
+    int leader;                // Group leader fd (cycles), -1 if unavailable
+
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    // Open the counters for the calling thread
+    bool open();
+    void close();
+
+    // Reset and start counting / stop counting and read the values
+    void start();
+    PerfCounts stop();
+
+    bool isOpen() const;
+};
+
+// Whether hardware counters can be used in this process (probed once)
+bool perfCountersAvailable();
+
+// Why the counters are unavailable (empty when they are available)
+std::string perfUnavailableReason();
+
+#endif // PERF_COUNTERS_H
@@ -1,112 +1,485 @@
 #include "sudoku_solver.h"
+#include "bench_stats.h"
+#include "system_info.h"
+#include "puzzle_io.h"
+#include "baseline.h"
+#include "alloc_counter.h"
+#include "candidate_kernels.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <iomanip>
+#include <string>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <omp.h>
+#include <algorithm>
+#include <map>
+
+#ifndef SUDOKU_CORPUS_PATH
+#define SUDOKU_CORPUS_PATH "benchmarks/corpus.txt"
+#endif
 
 // Structure to store performance results
 struct PerformanceResult {
     int boardSize;
+    std::string puzzleName;
+    std::string category;
+    long long expectedSolutions;
+    bool correct;           // Every repetition found the expected number of solutions
     std::string strategy;
     int numThreads;
     int partitionDepth;
-    int numSolutions;
-    double executionTime;
-    double speedup;
+    long long numSolutions;
+    double executionTime;   // Median over the repetitions
+    double speedup;         // Median baseline time / median time
     double efficiency;
+    std::vector<double> samples;  // Time of every repetition (ms)
+    TimingSummary timing;
+    double speedupCILow;    // Bootstrap confidence interval of the speedup
+    double speedupCIHigh;
+    ThreadStats totals;     // Search statistics summed over threads
+    int numSubproblems;     // Parallel tasks created
+    PerfCounts frontierCounters;            // Hardware counters of subproblem generation
+    ImbalanceSummary imbalance;             // Subproblem size distribution and thread balance
+    std::vector<ThreadStats> perThread;     // Busy / idle time of every thread
+    std::vector<int> threadCpus;            // NUMA-aware runs: CPU and node of every thread
+    std::vector<int> threadNodes;
+    AllocCounts allocations;                // Heap allocations during the solve
+    long long frontierBytes;                // Memory of the subproblem frontier
+    long long peakRssKb;                    // Peak resident set size during the solve (-1 if unknown)
+};
+
+// Command-line options of the benchmark
+struct BenchmarkOptions {
+    bool trace;         // Write a Chrome trace of every parallel run
+    bool perfCounters;  // Read hardware counters when available
+    int warmupRuns;     // Untimed runs before the repetitions
+    int repetitions;    // Timed runs per configuration
+    double confidence;  // Confidence level of the bootstrap intervals
+    int resamples;      // Bootstrap resamples
+    bool pinThreads;    // Pin OpenMP threads to CPUs
+    bool numaAware;     // NUMA-aware placement and frontier shards in the optimized strategy
+    std::string corpusPath;        // Benchmark corpus to run
+    std::vector<int> sizes;        // Only run puzzles of these sizes (empty = all)
+    std::string category;          // Only run puzzles of this category (empty = all)
+    std::vector<std::string> puzzles;  // Only run puzzles with these names (empty = all)
+    std::string baselinePath;      // Earlier performance_results.csv to compare against (empty = none)
+    double timeTolerance;          // Allowed relative slowdown of the median time
+    double nodeTolerance;          // Allowed relative increase of the node count
+    double minCompareMs;           // Baseline times below this are too noisy to compare
+    bool scaling;                  // Run the strong / weak scaling study instead of the report
+    int maxThreads;                // Largest thread count of the scaling sweep
+    std::string strongPuzzle;      // Corpus puzzle solved at every thread count
+    std::string weakPuzzle;        // Corpus puzzle copied unitsPerThread times per thread
+    int unitsPerThread;            // Weak scaling work per thread
+    int scalingDepth;              // Partition depth of the strong scaling runs
+    SearchEngine engine;           // Subproblem search of the optimized strategy
+    
+    BenchmarkOptions()
+        : trace(false), perfCounters(true), warmupRuns(1), repetitions(5),
+          confidence(0.95), resamples(2000), pinThreads(false), numaAware(false), corpusPath(SUDOKU_CORPUS_PATH),
+          timeTolerance(0.10), nodeTolerance(0.0), minCompareMs(1.0), scaling(false),
+          maxThreads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+          strongPuzzle("9x9-pathological-sparse"), weakPuzzle("9x9-hard-inkala"), unitsPerThread(4),
+          scalingDepth(3), engine(SEARCH_ROW_MAJOR) {}
 };
 
-// Get test board for 9x9
-std::vector<int> getTestBoard9x9() {
-    return {
-        5, 3, 0, 0, 7, 0, 0, 0, 0,
-        6, 0, 0, 1, 9, 5, 0, 0, 0,
-        0, 9, 8, 0, 0, 0, 0, 6, 0,
-        8, 0, 0, 0, 6, 0, 0, 0, 3,
-        4, 0, 0, 8, 0, 3, 0, 0, 1,
-        7, 0, 0, 0, 2, 0, 0, 0, 6,
-        0, 6, 0, 0, 0, 0, 2, 8, 0,
-        0, 0, 0, 4, 1, 9, 0, 0, 5,
-        0, 0, 0, 0, 8, 0, 0, 7, 9
-    };
-}
-
-// Get a harder test board with more empty cells
-std::vector<int> getHardTestBoard9x9() {
-    return {
-        0, 0, 3, 0, 2, 0, 6, 0, 0,
-        9, 0, 0, 3, 0, 5, 0, 0, 1,
-        0, 0, 1, 8, 0, 6, 4, 0, 0,
-        0, 0, 8, 1, 0, 2, 9, 0, 0,
-        7, 0, 0, 0, 0, 0, 0, 0, 8,
-        0, 0, 6, 7, 0, 8, 2, 0, 0,
-        0, 0, 2, 6, 0, 9, 5, 0, 0,
-        8, 0, 0, 2, 0, 3, 0, 0, 9,
-        0, 0, 5, 0, 1, 0, 3, 0, 0
-    };
-}
-
-// Get a very hard test board with many solutions for better parallel demonstration
-std::vector<int> getVeryHardTestBoard9x9() {
-    // This board has fewer hints to create more branching
-    return {
-        0, 0, 0, 0, 0, 0, 0, 1, 2,
-        0, 0, 0, 0, 3, 5, 0, 0, 0,
-        0, 0, 0, 6, 0, 0, 0, 7, 0,
-        7, 0, 0, 0, 0, 0, 3, 0, 0,
-        0, 0, 0, 4, 0, 0, 8, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 1, 2, 0, 0, 0, 0,
-        0, 8, 0, 0, 0, 0, 0, 4, 0,
-        0, 5, 0, 0, 0, 0, 6, 0, 0
-    };
-}
-
-// Generate performance report
-void generatePerformanceReport() {
+// Copy the search statistics of the last solve into a result
+void recordStats(PerformanceResult& result, const SudokuSolver& solver) {
+    result.totals = solver.getStats().total();
+    result.numSubproblems = solver.getStats().numSubproblems;
+    result.frontierCounters = solver.getStats().frontierCounters;
+    result.imbalance = summarizeImbalance(solver.getStats());
+    result.perThread = solver.getStats().perThread;
+    result.frontierBytes = solver.getStats().frontierBytes;
+    result.threadCpus = solver.getStats().threadCpus;
+    result.threadNodes = solver.getStats().threadNodes;
+}
+
+// Print the memory use of a run
+void printMemory(const PerformanceResult& result, const std::string& indent) {
+    std::cout << indent << "Memory: " << result.allocations.allocations << " allocations, "
+              << std::fixed << std::setprecision(1) << result.allocations.bytes / 1024.0 << " KB allocated, frontier "
+              << result.frontierBytes / 1024.0 << " KB";
+    if (result.peakRssKb >= 0) {
+        std::cout << ", peak RSS " << result.peakRssKb / 1024.0 << " MB";
+    }
+    std::cout << "\n";
+}
+
+// Print the hardware counters of a run (nothing when they were not counted)
+void printCounters(const PerformanceResult& result, const std::string& indent) {
+    const PerfCounts& counters = result.totals.counters;
+    if (!counters.valid()) {
+        return;
+    }
+    std::cout << indent << "Counters: IPC " << std::fixed << std::setprecision(2) << counters.ipc();
+    for (int event = PERF_L1D_MISSES; event < NUM_PERF_EVENTS; ++event) {
+        double rate = counters.perKiloInstructions(event);
+        if (rate >= 0.0) {
+            std::cout << ", " << perfEventName(event) << "/kinstr " << std::setprecision(3) << rate;
+        }
+    }
+    if (result.frontierCounters.valid()) {
+        std::cout << ", frontier cycles " << result.frontierCounters.values[PERF_CYCLES];
+    }
+    std::cout << "\n";
+}
+
+// Write one counter as a CSV field (empty when not counted)
+void writeCounterField(std::ofstream& csvFile, long long value) {
+    if (value >= 0) {
+        csvFile << value;
+    }
+}
+
+// Print the load balance of a parallel run below its timing line
+void printImbalance(const PerformanceResult& result, const std::string& indent) {
+    const ImbalanceSummary& imbalance = result.imbalance;
+    std::cout << indent << "Subproblems: " << imbalance.numSubproblems
+              << ", time (ms) min/median/p99/max: " << std::fixed << std::setprecision(3)
+              << imbalance.durationMs.min << "/" << imbalance.durationMs.median << "/"
+              << imbalance.durationMs.p99 << "/" << imbalance.durationMs.max
+              << ", largest 1%: " << std::setprecision(1) << imbalance.durationMs.topShare * 100.0
+              << "% of time\n";
+    std::cout << indent << "Busy/idle (ms) per thread:";
+    for (size_t t = 0; t < result.perThread.size(); ++t) {
+        std::cout << " " << t << ":" << std::setprecision(1) << result.perThread[t].busyMs
+                  << "/" << result.perThread[t].idleMs;
+    }
+    std::cout << ", max/mean busy: " << std::setprecision(2) << imbalance.imbalanceFactor() << "\n";
+    if (!result.threadCpus.empty()) {
+        std::cout << indent << "Placement (thread:cpu/node, stolen tasks):";
+        for (size_t t = 0; t < result.threadCpus.size() && t < result.perThread.size(); ++t) {
+            std::cout << " " << t << ":" << result.threadCpus[t] << "/" << result.threadNodes[t]
+                      << "," << result.perThread[t].subproblemsStolen;
+        }
+        std::cout << "\n";
+    }
+}
+
+// Attach a new tracer to the solver when tracing is enabled
+std::unique_ptr<Tracer> attachTracer(const BenchmarkOptions& options, SudokuSolver& solver, int threads) {
+    std::unique_ptr<Tracer> tracer;
+    if (options.trace) {
+        tracer.reset(new Tracer(threads));
+        solver.setTracer(tracer.get());
+    }
+    return tracer;
+}
+
+// Write the trace of one run (no-op when tracing is disabled)
+void saveTrace(const std::unique_ptr<Tracer>& tracer, const std::string& path) {
+    if (!tracer) {
+        return;
+    }
+    if (tracer->writeChromeTrace(path)) {
+        std::cout << "      Trace written to " << path;
+        if (tracer->getDroppedEvents() > 0) {
+            std::cout << " (" << tracer->getDroppedEvents() << " oldest events dropped)";
+        }
+        std::cout << "\n";
+    }
+}
+
+// Run one configuration: warmups, then timed repetitions of the production path
+// (NoStats kernels, no counters), then one untimed profiling run. Search statistics,
+// counters, allocation counts, peak RSS and the trace come from the profiling run.
+template <typename SolveFn>
+void measure(const BenchmarkOptions& options, int N, const std::vector<int>& board, int threads,
+             SolveFn solve, PerformanceResult& result, const std::string& tracePath) {
+    if (options.pinThreads) {
+        pinThreads(threads);
+    }
+    
+    int totalRuns = options.warmupRuns + options.repetitions + 1;
+    result.samples.clear();
+    result.correct = true;
+    for (int run = 0; run < totalRuns; ++run) {
+        bool profileRun = (run == totalRuns - 1);
+        
+        SudokuSolver solver(N);
+        solver.loadBoard(board);
+        solver.setCollectStats(profileRun);
+        solver.setPerfCounters(profileRun && options.perfCounters);
+        solver.setNumaAware(options.numaAware);
+        std::unique_ptr<Tracer> tracer;
+        if (profileRun) {
+            tracer = attachTracer(options, solver, threads);
+            // Without the reset, peak RSS is the maximum over the whole process so far
+            resetPeakRss();
+        }
+        AllocCounts allocationsBefore = allocCountsNow();
+        solve(solver);
+        AllocCounts allocations = allocCountsNow() - allocationsBefore;
+        
+        if (solver.getNumSolutions() != result.expectedSolutions) {
+            result.correct = false;
+            result.numSolutions = solver.getNumSolutions();
+        }
+        if (profileRun) {
+            if (result.correct) {
+                result.numSolutions = solver.getNumSolutions();
+            }
+            recordStats(result, solver);
+            result.allocations = allocations;
+            result.peakRssKb = peakRssKb();
+            saveTrace(tracer, tracePath);
+        } else if (run >= options.warmupRuns) {
+            result.samples.push_back(solver.getRunningTime());
+        }
+    }
+    
+    result.timing = summarizeTimings(result.samples, options.confidence, options.resamples,
+                                     0x5EED0000u + static_cast<uint64_t>(threads));
+    result.executionTime = result.timing.median;
+}
+
+// Speedup and efficiency of a result against the baseline samples
+void computeSpeedup(const BenchmarkOptions& options, const std::vector<double>& baselineSamples,
+                    PerformanceResult& result) {
+    double baselineTime = median(baselineSamples);
+    result.speedup = (result.executionTime > 0) ? (baselineTime / result.executionTime) : 1.0;
+    result.efficiency = (result.speedup / result.numThreads) * 100.0;
+    bootstrapRatioCI(baselineSamples, result.samples, options.confidence, options.resamples,
+                     0xC0FFEEu + static_cast<uint64_t>(result.numThreads),
+                     result.speedupCILow, result.speedupCIHigh);
+}
+
+// Print the timing line of one configuration
+void printTiming(const PerformanceResult& result, const std::string& indent) {
+    const TimingSummary& timing = result.timing;
+    std::cout << indent << "Threads: " << result.numThreads
+              << ", Time: " << std::fixed << std::setprecision(2) << timing.median << " ms"
+              << " [" << timing.ciLow << ", " << timing.ciHigh << "]"
+              << " (p95 " << timing.p95 << ", sd " << timing.stddev << ", n=" << timing.repetitions << ")";
+    if (result.strategy != "Baseline") {
+        std::cout << ", Speedup: " << result.speedup << "x"
+                  << " [" << result.speedupCILow << ", " << result.speedupCIHigh << "]"
+                  << ", Efficiency: " << std::setprecision(1) << result.efficiency << "%";
+    }
+    std::cout << "\n";
+}
+
+// Quote a CSV field that may contain commas
+std::string csvQuote(const std::string& field) {
+    std::string quoted = "\"";
+    for (char c : field) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// New result for one configuration of a corpus puzzle
+PerformanceResult makeResult(const CorpusEntry& entry, const std::string& strategy, int threads, int depth) {
+    PerformanceResult result;
+    result.boardSize = entry.puzzle.N;
+    result.puzzleName = entry.name;
+    result.category = entry.category;
+    result.expectedSolutions = entry.expectedSolutions;
+    result.correct = true;
+    result.strategy = strategy;
+    result.numThreads = threads;
+    result.partitionDepth = depth;
+    result.numSolutions = 0;
+    result.frontierBytes = 0;
+    result.peakRssKb = -1;
+    return result;
+}
+
+// Report a run that found the wrong number of solutions
+void printMismatch(const PerformanceResult& result, const std::string& indent) {
+    if (!result.correct) {
+        std::cout << indent << "MISMATCH: expected " << result.expectedSolutions
+                  << " solutions, found " << result.numSolutions << "\n";
+    }
+}
+
+// Whether the options select a corpus entry
+bool selected(const BenchmarkOptions& options, const CorpusEntry& entry) {
+    if (!options.sizes.empty()
+        && std::find(options.sizes.begin(), options.sizes.end(), entry.puzzle.N) == options.sizes.end()) {
+        return false;
+    }
+    if (!options.puzzles.empty()
+        && std::find(options.puzzles.begin(), options.puzzles.end(), entry.name) == options.puzzles.end()) {
+        return false;
+    }
+    return options.category.empty() || options.category == entry.category;
+}
+
+// Compare every configuration with the baseline file and print a diff table. A
+// configuration regresses when its node count grows beyond the node tolerance, or
+// when the whole bootstrap interval of its time ratio lies above 1 + time tolerance.
+// Only configurations with at most one thread per allowed CPU are timed against the
+// baseline: oversubscribed runs vary with the scheduler far more than any tolerance,
+// so they are checked for node counts only. Times of configurations faster than
+// minCompareMs cannot be judged; they are reported as skipped, with a warning, so a
+// gate on too small a workload is visible.
+// Returns the number of regressions (or -1 if the baseline cannot be read).
+int compareWithBaseline(const BenchmarkOptions& options, const std::vector<PerformanceResult>& results) {
+    std::map<std::string, BaselineEntry> baseline;
+    if (!loadBaselineFile(options.baselinePath, baseline)) {
+        return -1;
+    }
+    
+    std::cout << "\n=== Comparison with Baseline " << options.baselinePath << " ===\n";
+    std::cout << "Tolerances: time +" << std::fixed << std::setprecision(1) << options.timeTolerance * 100.0
+              << "% (runs of at least " << std::setprecision(2) << options.minCompareMs << " ms), nodes +"
+              << std::setprecision(1) << options.nodeTolerance * 100.0 << "%\n";
+    std::cout << std::left << std::setw(24) << "Puzzle" << std::setw(11) << "Strategy" << std::right
+              << std::setw(4) << "Thr" << std::setw(6) << "Depth" << std::setw(12) << "Base (ms)"
+              << std::setw(12) << "Now (ms)" << std::setw(24) << "Ratio [CI]"
+              << std::setw(14) << "Base nodes" << std::setw(14) << "Nodes" << "  Verdict\n";
+    
+    const int allowedCpus = static_cast<int>(getCpuTopology().cpus.size());
+    int regressions = 0;
+    int compared = 0;
+    int tooShort = 0;
+    int oversubscribed = 0;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(24) << result.puzzleName << std::setw(11) << result.strategy
+                  << std::right << std::setw(4) << result.numThreads << std::setw(6) << result.partitionDepth;
+        
+        auto found = baseline.find(baselineKey(result.puzzleName, result.strategy,
+                                               result.numThreads, result.partitionDepth));
+        if (found == baseline.end()) {
+            std::cout << std::setw(12) << "-" << std::setw(12) << std::setprecision(2) << result.executionTime
+                      << std::setw(24) << "-" << std::setw(14) << "-" << std::setw(14)
+                      << result.totals.nodesVisited << "  new\n";
+            continue;
+        }
+        const BaselineEntry& base = found->second;
+        ++compared;
+        
+        // Median time ratio with a bootstrap interval over both sets of repetitions
+        std::vector<double> baseSamples = base.samples;
+        if (baseSamples.empty()) {
+            baseSamples.push_back(base.medianMs);
+        }
+        double ratioLow = 0.0, ratioHigh = 0.0;
+        bootstrapRatioCI(result.samples, baseSamples, options.confidence, options.resamples,
+                         0xBA5E0000u + static_cast<uint64_t>(compared), ratioLow, ratioHigh);
+        double ratio = (median(baseSamples) > 0.0) ? result.executionTime / median(baseSamples) : 1.0;
+        
+        std::string verdict = "ok";
+        long long nodes = result.totals.nodesVisited;
+        if (base.nodes >= 0 && nodes > base.nodes * (1.0 + options.nodeTolerance)) {
+            verdict = "REGRESSION (nodes)";
+        } else if (result.numThreads > allowedCpus) {
+            verdict = "ok (time not gated)";
+            ++oversubscribed;
+        } else if (base.medianMs < options.minCompareMs) {
+            verdict = "SKIPPED (too short to time)";
+            ++tooShort;
+        } else if (ratioLow > 1.0 + options.timeTolerance) {
+            verdict = "REGRESSION (time)";
+        } else if (ratioHigh < 1.0 / (1.0 + options.timeTolerance)) {
+            verdict = "faster";
+        } else if (base.nodes >= 0 && nodes != base.nodes) {
+            verdict = "ok (nodes changed)";
+        }
+        if (verdict.compare(0, 10, "REGRESSION") == 0) {
+            ++regressions;
+        }
+        
+        std::ostringstream ratioText;
+        ratioText << std::fixed << std::setprecision(3) << ratio << " [" << ratioLow << ", " << ratioHigh << "]";
+        std::cout << std::setprecision(2) << std::setw(12) << base.medianMs << std::setw(12) << result.executionTime
+                  << std::setw(24) << ratioText.str() << std::setw(14) << base.nodes
+                  << std::setw(14) << nodes << "  " << verdict << "\n";
+    }
+    
+    std::cout << "\nBaseline: " << compared << " configurations compared, " << regressions << " regression"
+              << (regressions == 1 ? "" : "s") << "\n";
+    if (oversubscribed > 0) {
+        std::cout << oversubscribed << " configuration" << (oversubscribed == 1 ? " has" : "s have")
+                  << " more threads than the " << allowedCpus << " allowed CPU" << (allowedCpus == 1 ? "" : "s")
+                  << "; only their node counts were gated\n";
+    }
+    if (tooShort > 0) {
+        std::cout << "Warning: " << tooShort << " configuration" << (tooShort == 1 ? " was" : "s were")
+                  << " too short to time (baseline under " << std::setprecision(2) << options.minCompareMs
+                  << " ms) and only checked for node counts\n";
+    }
+    return regressions;
+}
+
+// Generate performance report over the benchmark corpus; returns the number of
+// configurations that found a wrong solution count or regressed against the
+// baseline (or -1 if the corpus or baseline is missing)
+int generatePerformanceReport(const BenchmarkOptions& options) {
     std::vector<PerformanceResult> results;
-    std::vector<int> boardSizes = {9};  // Can extend to 16, 25 for larger boards
-    std::vector<int> threadCounts = {1, 2, 4, 8};
+    // Powers of two up to the machine size, but at least up to 8 threads
+    std::vector<int> threadCounts = scalingThreadCounts(
+        std::max(8, static_cast<int>(std::thread::hardware_concurrency())));
     std::vector<int> partitionDepths = {1, 2, 3};
     
     std::cout << "Performance Analysis for Parallel Sudoku Solver\n";
     std::cout << "===============================================\n\n";
     
-    for (int N : boardSizes) {
-        std::vector<int> board;
-        
-        // Get appropriate test board
-        if (N == 9) {
-            board = getVeryHardTestBoard9x9();  // Use harder test board
+    std::vector<CorpusEntry> corpus;
+    if (!loadCorpusFile(options.corpusPath, corpus)) {
+        std::cerr << "Use --corpus <file> to point at benchmarks/corpus.txt\n";
+        return -1;
+    }
+    std::cout << "Corpus: " << options.corpusPath << " (" << corpus.size() << " puzzles)\n";
+    
+    SystemInfo system = collectSystemInfo();
+    std::cout << "CPU: " << system.cpuModel << " (" << system.logicalCpus << " logical CPUs, "
+              << system.physicalCores << " cores)\n";
+    std::cout << "Compiler: " << system.compiler << ", flags: " << system.compileFlags << "\n";
+    std::cout << "Topology: " << describeNumaLayout()
+              << (options.numaAware ? "; optimized strategy NUMA-aware (pinned, per-node frontier shards)" : "")
+              << "\n";
+    std::cout << "Runs per configuration: " << options.warmupRuns << " warmup + "
+              << options.repetitions << " timed; times are medians with "
+              << static_cast<int>(options.confidence * 100) << "% bootstrap intervals"
+              << (options.pinThreads ? "; threads pinned" : "") << "\n";
+    const char* kernelPath = candidateKernelName();  // Selection warnings come before the line
+    std::cout << "Optimized strategy search: "
+              << (options.engine == SEARCH_PROPAGATION ? "propagation (naked/hidden singles + MRV)"
+                  : options.engine == SEARCH_CDCL ? "CDCL (clause learning, blocking clauses)" : "row-major")
+              << ", kernel path: " << kernelPath << "\n\n";
+    
+    if (options.perfCounters) {
+        if (perfCountersAvailable()) {
+            std::cout << "Hardware counters: enabled (user-space events per thread)\n\n";
         } else {
-            std::cerr << "Warning: No test board available for " << N << "x" << N << " board, skipping...\n";
-            continue;
+            std::cout << "Hardware counters: unavailable, " << perfUnavailableReason()
+                      << "\nReporting timings only.\n\n";
         }
+    }
+    
+    for (const CorpusEntry& entry : corpus) {
+        if (!selected(options, entry)) continue;
+        
+        int N = entry.puzzle.N;
+        const std::vector<int>& board = entry.puzzle.board;
+        std::string traceName = entry.name;
         
-        std::cout << "Testing " << N << "x" << N << " board...\n";
+        std::cout << "Testing " << entry.name << " (" << N << "x" << N << ", " << entry.category
+                  << ", expected solutions: " << entry.expectedSolutions << ")...\n";
         
-        double baselineTime = 0.0;
+        std::vector<double> baselineSamples;
         
         // Test single thread baseline
         {
-            SudokuSolver solver(N);
-            solver.loadBoard(board);
-            solver.solveSingleThread();
-            baselineTime = solver.getRunningTime();
-            
-            PerformanceResult result;
-            result.boardSize = N;
-            result.strategy = "Baseline";
-            result.numThreads = 1;
-            result.partitionDepth = 0;
-            result.numSolutions = solver.getNumSolutions();
-            result.executionTime = solver.getRunningTime();
-            result.speedup = 1.0;
-            result.efficiency = 100.0;
+            PerformanceResult result = makeResult(entry, "Baseline", 1, 0);
+            measure(options, N, board, 1, [](SudokuSolver& solver) { solver.solveSingleThread(); },
+                    result, "");
+            baselineSamples = result.samples;
+            computeSpeedup(options, baselineSamples, result);
             results.push_back(result);
             
-            std::cout << "  [Baseline] Threads: 1, Time: " << std::fixed << std::setprecision(2) 
-                     << result.executionTime << " ms\n";
+            std::cout << "  [Baseline] ";
+            printTiming(result, "");
+            printMismatch(result, "      ");
+            printCounters(result, "      ");
+            printMemory(result, "      ");
         }
         
         // Test old parallel strategy
@@ -114,55 +487,51 @@ void generatePerformanceReport() {
         for (int threads : threadCounts) {
             if (threads == 1) continue;
             
-            SudokuSolver solver(N);
-            solver.loadBoard(board);
-            solver.solveParallel(threads);
-            
-            PerformanceResult result;
-            result.boardSize = N;
-            result.strategy = "Old";
-            result.numThreads = threads;
-            result.partitionDepth = 1;
-            result.numSolutions = solver.getNumSolutions();
-            result.executionTime = solver.getRunningTime();
-            result.speedup = (baselineTime > 0) ? (baselineTime / result.executionTime) : 1.0;
-            result.efficiency = (result.speedup / threads) * 100.0;
+            PerformanceResult result = makeResult(entry, "Old", threads, 1);
+            measure(options, N, board, threads,
+                    [threads](SudokuSolver& solver) { solver.solveParallel(threads); }, result,
+                    "trace_" + traceName + "_old_" + std::to_string(threads) + "t.json");
+            computeSpeedup(options, baselineSamples, result);
             results.push_back(result);
             
-            std::cout << "    Threads: " << threads 
-                     << ", Time: " << std::fixed << std::setprecision(2) 
-                     << result.executionTime << " ms"
-                     << ", Speedup: " << std::setprecision(2) << result.speedup << "x"
-                     << ", Efficiency: " << std::setprecision(1) << result.efficiency << "%\n";
+            printTiming(result, "    ");
+            printMismatch(result, "      ");
+            printImbalance(result, "      ");
+            printCounters(result, "      ");
+            printMemory(result, "      ");
         }
         
         // Test optimized parallel strategy with different partition depths
-        std::cout << "\n  Testing OPTIMIZED strategy (K-level partitioning):\n";
+        // (reported as "Propagation" or "CDCL" when the subproblems use another search)
+        std::string optimizedStrategy = (options.engine == SEARCH_PROPAGATION) ? "Propagation"
+                                      : (options.engine == SEARCH_CDCL) ? "CDCL" : "Optimized";
+        std::cout << "\n  Testing OPTIMIZED strategy (K-level partitioning"
+                  << (options.engine == SEARCH_PROPAGATION ? ", propagation search"
+                      : options.engine == SEARCH_CDCL ? ", CDCL search" : "") << "):\n";
         for (int depth : partitionDepths) {
             std::cout << "    Partition Depth = " << depth << ":\n";
             for (int threads : threadCounts) {
                 if (threads == 1) continue;
                 
-                SudokuSolver solver(N);
-                solver.loadBoard(board);
-                solver.solveParallelOptimized(threads, depth);
-                
-                PerformanceResult result;
-                result.boardSize = N;
-                result.strategy = "Optimized";
-                result.numThreads = threads;
-                result.partitionDepth = depth;
-                result.numSolutions = solver.getNumSolutions();
-                result.executionTime = solver.getRunningTime();
-                result.speedup = (baselineTime > 0) ? (baselineTime / result.executionTime) : 1.0;
-                result.efficiency = (result.speedup / threads) * 100.0;
+                PerformanceResult result = makeResult(entry, optimizedStrategy, threads, depth);
+                SearchEngine engine = options.engine;
+                measure(options, N, board, threads,
+                        [threads, depth, engine](SudokuSolver& solver) {
+                            solver.setSearchEngine(engine);
+                            solver.solveParallelOptimized(threads, depth);
+                        },
+                        result,
+                        "trace_" + traceName + "_"
+                        + (engine == SEARCH_PROPAGATION ? "propagation" : engine == SEARCH_CDCL ? "cdcl" : "optimized")
+                        + "_d" + std::to_string(depth) + "_" + std::to_string(threads) + "t.json");
+                computeSpeedup(options, baselineSamples, result);
                 results.push_back(result);
                 
-                std::cout << "      Threads: " << threads 
-                         << ", Time: " << std::fixed << std::setprecision(2) 
-                         << result.executionTime << " ms"
-                         << ", Speedup: " << std::setprecision(2) << result.speedup << "x"
-                         << ", Efficiency: " << std::setprecision(1) << result.efficiency << "%\n";
+                printTiming(result, "      ");
+                printMismatch(result, "        ");
+                printImbalance(result, "        ");
+                printCounters(result, "        ");
+                printMemory(result, "        ");
             }
         }
         std::cout << "\n";
@@ -171,17 +540,65 @@ void generatePerformanceReport() {
     // Write results to CSV file
     std::ofstream csvFile("performance_results.csv");
     if (csvFile.is_open()) {
-        csvFile << "Board Size,Strategy,Threads,Partition Depth,Solutions,Execution Time (ms),Speedup,Efficiency (%)\n";
+        csvFile << "Board Size,Puzzle,Category,Strategy,Threads,Partition Depth,Solutions,Expected Solutions,Correct,Execution Time (ms),Speedup,Efficiency (%),"
+                << "Nodes,Backtracks,Dead Ends,Propagations,Subproblems,Busy Time (ms),Idle Time (ms)";
+        for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+            csvFile << "," << perfEventName(event);
+        }
+        csvFile << ",Frontier Cycles,Allocations,Bytes Allocated,Frontier Bytes,Peak RSS (KB),Warmup Runs,Repetitions,Median Time (ms),P95 Time (ms),Mean Time (ms),"
+                << "Std Dev (ms),Time CI Low (ms),Time CI High (ms),Speedup CI Low,Speedup CI High,"
+                << "Pinned,CPU,Logical CPUs,Physical Cores,Compiler,Compile Flags,Samples (ms)\n";
         
         for (const auto& result : results) {
             csvFile << result.boardSize << ","
+                   << result.puzzleName << ","
+                   << result.category << ","
                    << result.strategy << ","
                    << result.numThreads << ","
                    << result.partitionDepth << ","
                    << result.numSolutions << ","
+                   << result.expectedSolutions << ","
+                   << (result.correct ? "yes" : "no") << ","
                    << std::fixed << std::setprecision(2) << result.executionTime << ","
                    << std::fixed << std::setprecision(4) << result.speedup << ","
-                   << std::fixed << std::setprecision(2) << result.efficiency << "\n";
+                   << std::fixed << std::setprecision(2) << result.efficiency << ","
+                   << result.totals.nodesVisited << ","
+                   << result.totals.backtracks << ","
+                   << result.totals.deadEnds << ","
+                   << result.totals.propagations << ","
+                   << result.numSubproblems << ","
+                   << std::fixed << std::setprecision(2) << result.totals.busyMs << ","
+                   << std::fixed << std::setprecision(2) << result.totals.idleMs;
+            for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+                csvFile << ",";
+                writeCounterField(csvFile, result.totals.counters.values[event]);
+            }
+            csvFile << ",";
+            writeCounterField(csvFile, result.frontierCounters.values[PERF_CYCLES]);
+            csvFile << "," << result.allocations.allocations << ","
+                    << result.allocations.bytes << ","
+                    << result.frontierBytes << ",";
+            writeCounterField(csvFile, result.peakRssKb);
+            csvFile << "," << options.warmupRuns << ","
+                    << result.timing.repetitions << ","
+                    << std::fixed << std::setprecision(2) << result.timing.median << ","
+                    << result.timing.p95 << ","
+                    << result.timing.mean << ","
+                    << result.timing.stddev << ","
+                    << result.timing.ciLow << ","
+                    << result.timing.ciHigh << ","
+                    << std::setprecision(4) << result.speedupCILow << ","
+                    << result.speedupCIHigh << ","
+                    << (options.pinThreads ? "yes" : "no") << ","
+                    << csvQuote(system.cpuModel) << ","
+                    << system.logicalCpus << ","
+                    << system.physicalCores << ","
+                    << csvQuote(system.compiler) << ","
+                    << csvQuote(system.compileFlags) << ",";
+            for (size_t i = 0; i < result.samples.size(); ++i) {
+                csvFile << (i > 0 ? ";" : "") << std::setprecision(3) << result.samples[i];
+            }
+            csvFile << "\n";
         }
         
         csvFile.close();
@@ -190,6 +607,71 @@ void generatePerformanceReport() {
         std::cerr << "Error: Could not create CSV file\n";
     }
     
+    // Write the subproblem distributions, one row per parallel run
+    std::ofstream imbalanceFile("load_imbalance.csv");
+    if (imbalanceFile.is_open()) {
+        imbalanceFile << "Board Size,Puzzle,Strategy,Threads,Partition Depth,Subproblems,"
+                      << "Min Task (ms),Median Task (ms),P99 Task (ms),Max Task (ms),Top 1% Time Share (%),"
+                      << "Min Nodes,Median Nodes,P99 Nodes,Max Nodes,Top 1% Node Share (%),"
+                      << "Max Busy (ms),Mean Busy (ms),Max/Mean Busy,Total Idle (ms)\n";
+        
+        for (const auto& result : results) {
+            if (result.strategy == "Baseline") continue;
+            
+            const ImbalanceSummary& imbalance = result.imbalance;
+            imbalanceFile << result.boardSize << ","
+                          << result.puzzleName << ","
+                          << result.strategy << ","
+                          << result.numThreads << ","
+                          << result.partitionDepth << ","
+                          << imbalance.numSubproblems << ","
+                          << std::fixed << std::setprecision(4)
+                          << imbalance.durationMs.min << ","
+                          << imbalance.durationMs.median << ","
+                          << imbalance.durationMs.p99 << ","
+                          << imbalance.durationMs.max << ","
+                          << std::setprecision(2) << imbalance.durationMs.topShare * 100.0 << ","
+                          << std::setprecision(0)
+                          << imbalance.nodes.min << ","
+                          << imbalance.nodes.median << ","
+                          << imbalance.nodes.p99 << ","
+                          << imbalance.nodes.max << ","
+                          << std::setprecision(2) << imbalance.nodes.topShare * 100.0 << ","
+                          << imbalance.maxBusyMs << ","
+                          << imbalance.meanBusyMs << ","
+                          << std::setprecision(3) << imbalance.imbalanceFactor() << ","
+                          << std::setprecision(2) << imbalance.totalIdleMs << "\n";
+        }
+        
+        imbalanceFile.close();
+        std::cout << "Load imbalance results saved to load_imbalance.csv\n";
+    } else {
+        std::cerr << "Error: Could not create load imbalance CSV file\n";
+    }
+    
+    // Effect of partition depth on imbalance at the largest thread count
+    int maxThreads = threadCounts.back();
+    std::cout << "\n=== Load Imbalance and Memory vs Partition Depth (" << maxThreads << " threads) ===\n";
+    std::cout << std::left << std::setw(24) << "Puzzle" << std::setw(8) << "Depth" << std::setw(13) << "Subproblems"
+              << std::setw(16) << "Max task (ms)" << std::setw(16) << "Largest 1% (%)"
+              << std::setw(16) << "Max/mean busy" << std::setw(12) << "Idle (ms)"
+              << std::setw(16) << "Frontier (KB)" << "Allocations\n" << std::right;
+    for (const auto& result : results) {
+        if (result.partitionDepth == 0 || result.strategy == "Old" || result.numThreads != maxThreads) continue;
+        
+        const ImbalanceSummary& imbalance = result.imbalance;
+        std::cout << std::left << std::fixed
+                  << std::setw(24) << result.puzzleName
+                  << std::setw(8) << result.partitionDepth
+                  << std::setw(13) << imbalance.numSubproblems
+                  << std::setw(16) << std::setprecision(2) << imbalance.durationMs.max
+                  << std::setw(16) << std::setprecision(1) << imbalance.durationMs.topShare * 100.0
+                  << std::setw(16) << std::setprecision(2) << imbalance.imbalanceFactor()
+                  << std::setw(12) << std::setprecision(1) << imbalance.totalIdleMs
+                  << std::setw(16) << result.frontierBytes / 1024.0
+                  << result.allocations.allocations << "\n" << std::right;
+    }
+    
     // Print summary
     std::cout << "\n=== Performance Summary ===\n";
     std::cout << "The optimized implementation uses K-level partitioning to create more\n";
@@ -200,9 +682,323 @@ void generatePerformanceReport() {
     std::cout << "2. K-level task partitioning (better parallelism)\n";
     std::cout << "3. Dynamic scheduling (better load balancing)\n";
     std::cout << "4. Reduced memory copying overhead\n";
+    
+    // Every configuration must reproduce the corpus answers
+    int mismatches = 0;
+    for (const auto& result : results) {
+        if (!result.correct) ++mismatches;
+    }
+    std::cout << "\nVerification: " << (results.size() - mismatches) << "/" << results.size()
+              << " configurations found the expected number of solutions\n";
+    
+    if (!options.baselinePath.empty()) {
+        int regressions = compareWithBaseline(options, results);
+        if (regressions < 0) {
+            return -1;
+        }
+        return mismatches + regressions;
+    }
+    return mismatches;
+}
+
+// One thread count of a scaling sweep
+struct ScalingPoint {
+    std::string mode;       // "strong" or "weak"
+    std::string puzzleName;
+    int numThreads;
+    int workUnits;          // Puzzles solved per run
+    std::string placement;  // cores, cores+smt or oversubscribed
+    TimingSummary timing;
+    double speedup;         // Strong: T1 / Tp. Weak: scaled speedup p * T1 / Tp
+    double efficiency;      // Speedup / p
+    double serialFraction;  // Karp-Flatt metric (1/S - 1/p) / (1 - 1/p); 0 for p = 1
+};
+
+// Where the threads of a p-thread run land when pinned in getCpuTopology() order
+std::string threadPlacement(int threads) {
+    const CpuTopology& topology = getCpuTopology();
+    if (threads <= topology.numCores) return "cores";
+    if (threads <= static_cast<int>(topology.cpus.size())) return "cores+smt";
+    return "oversubscribed";
+}
+
+// Time a run function over the warmups and repetitions of the options
+template <typename RunFn>
+TimingSummary timeRuns(const BenchmarkOptions& options, int threads, RunFn run) {
+    std::vector<double> samples;
+    for (int rep = 0; rep < options.warmupRuns + options.repetitions; ++rep) {
+        double ms = run();
+        if (rep >= options.warmupRuns) {
+            samples.push_back(ms);
+        }
+    }
+    return summarizeTimings(samples, options.confidence, options.resamples,
+                           0x5CA1E000u + static_cast<uint64_t>(threads));
+}
+
+// Solve units copies of a puzzle, distributed over the threads one puzzle at a time.
+// Each copy runs the sequential subproblem search; returns the wall time in ms.
+double solveBatch(const CorpusEntry& entry, SearchEngine engine, int units, int threads, long long& solutions) {
+    solutions = 0;
+    long long batchSolutions = 0;
+    double start = omp_get_wtime();
+    #pragma omp parallel for schedule(dynamic) num_threads(threads) reduction(+:batchSolutions)
+    for (int unit = 0; unit < units; ++unit) {
+        SudokuSolver solver(entry.puzzle.N);
+        solver.loadBoard(entry.puzzle.board);
+        solver.setSearchEngine(engine);
+        std::vector<Subproblem> frontier;
+        solver.generateSubproblems(1, frontier);
+        for (const Subproblem& subproblem : frontier) {
+            batchSolutions += solver.solveSubproblem(subproblem);
+        }
+    }
+    solutions = batchSolutions;
+    return (omp_get_wtime() - start) * 1000.0;
+}
+
+// Fill in speedup, efficiency and the Karp-Flatt serial fraction from T1
+void computeScaling(ScalingPoint& point, double singleThreadMs) {
+    int p = point.numThreads;
+    double ratio = (point.timing.median > 0.0) ? singleThreadMs / point.timing.median : 1.0;
+    point.speedup = (point.mode == "weak") ? p * ratio : ratio;
+    point.efficiency = point.speedup / p * 100.0;
+    point.serialFraction = (p > 1 && point.speedup > 0.0)
+                         ? (1.0 / point.speedup - 1.0 / p) / (1.0 - 1.0 / p) : 0.0;
+}
+
+// Strong and weak scaling over thread counts up to maxThreads. Threads are pinned
+// physical cores first, so the placement column separates core scaling from SMT.
+// Returns the number of runs that found a wrong solution count (-1 on setup errors).
+int runScalingStudy(const BenchmarkOptions& options) {
+    std::vector<CorpusEntry> corpus;
+    if (!loadCorpusFile(options.corpusPath, corpus)) {
+        std::cerr << "Use --corpus <file> to point at benchmarks/corpus.txt\n";
+        return -1;
+    }
+    const CorpusEntry* strongEntry = nullptr;
+    const CorpusEntry* weakEntry = nullptr;
+    for (const CorpusEntry& entry : corpus) {
+        if (entry.name == options.strongPuzzle) strongEntry = &entry;
+        if (entry.name == options.weakPuzzle) weakEntry = &entry;
+    }
+    if (!strongEntry || !weakEntry) {
+        std::cerr << "Error: Puzzle " << (strongEntry ? options.weakPuzzle : options.strongPuzzle)
+                  << " is not in " << options.corpusPath << "\n";
+        return -1;
+    }
+    
+    SystemInfo system = collectSystemInfo();
+    const CpuTopology& topology = getCpuTopology();
+    std::vector<int> threadCounts = scalingThreadCounts(options.maxThreads);
+    
+    std::cout << "Scaling Study for Parallel Sudoku Solver\n";
+    std::cout << "========================================\n\n";
+    std::cout << "CPU: " << system.cpuModel << "\n";
+    std::cout << "Allowed CPUs: " << topology.cpus.size() << " on " << topology.numCores
+              << " physical cores; threads are pinned one per core before using SMT siblings\n";
+    std::cout << "Topology: " << describeNumaLayout()
+              << (options.numaAware ? "; strong scaling runs NUMA-aware" : "") << "\n";
+    std::cout << "Thread counts:";
+    for (int threads : threadCounts) std::cout << " " << threads;
+    std::cout << "\nRuns per point: " << options.warmupRuns << " warmup + " << options.repetitions << " timed\n\n";
+    
+    std::vector<ScalingPoint> points;
+    int mismatches = 0;
+    
+    // Strong scaling: the same puzzle at every thread count
+    std::cout << "Strong scaling: " << strongEntry->name << ", partition depth " << options.scalingDepth << "\n";
+    double strongT1 = 0.0;
+    for (int threads : threadCounts) {
+        pinThreads(threads);
+        ScalingPoint point;
+        point.mode = "strong";
+        point.puzzleName = strongEntry->name;
+        point.numThreads = threads;
+        point.workUnits = 1;
+        point.placement = threadPlacement(threads);
+        point.timing = timeRuns(options, threads, [&]() {
+            SudokuSolver solver(strongEntry->puzzle.N);
+            solver.loadBoard(strongEntry->puzzle.board);
+            solver.setSearchEngine(options.engine);
+            solver.setNumaAware(options.numaAware);
+            solver.solveParallelOptimized(threads, options.scalingDepth);
+            if (solver.getNumSolutions() != strongEntry->expectedSolutions) ++mismatches;
+            return solver.getRunningTime();
+        });
+        if (threads == 1) strongT1 = point.timing.median;
+        computeScaling(point, strongT1);
+        points.push_back(point);
+    }
+    
+    // Weak scaling: unitsPerThread copies of a puzzle per thread
+    std::cout << "Weak scaling: " << weakEntry->name << ", " << options.unitsPerThread << " puzzles per thread\n\n";
+    double weakT1 = 0.0;
+    for (int threads : threadCounts) {
+        pinThreads(threads);
+        ScalingPoint point;
+        point.mode = "weak";
+        point.puzzleName = weakEntry->name;
+        point.numThreads = threads;
+        point.workUnits = options.unitsPerThread * threads;
+        point.placement = threadPlacement(threads);
+        point.timing = timeRuns(options, threads, [&]() {
+            long long solutions = 0;
+            double ms = solveBatch(*weakEntry, options.engine, point.workUnits, threads, solutions);
+            if (solutions != weakEntry->expectedSolutions * point.workUnits) ++mismatches;
+            return ms;
+        });
+        if (threads == 1) weakT1 = point.timing.median;
+        computeScaling(point, weakT1);
+        points.push_back(point);
+    }
+    
+    std::cout << std::left << std::setw(8) << "Mode" << std::right << std::setw(8) << "Threads"
+              << std::setw(16) << "Placement" << std::setw(8) << "Units" << std::setw(12) << "Time (ms)"
+              << std::setw(10) << "Speedup" << std::setw(13) << "Efficiency" << std::setw(14) << "Serial frac" << "\n";
+    for (const ScalingPoint& point : points) {
+        std::cout << std::left << std::setw(8) << point.mode << std::right << std::setw(8) << point.numThreads
+                  << std::setw(16) << point.placement << std::setw(8) << point.workUnits
+                  << std::fixed << std::setprecision(2) << std::setw(12) << point.timing.median
+                  << std::setw(10) << point.speedup
+                  << std::setw(12) << std::setprecision(1) << point.efficiency << "%"
+                  << std::setw(14) << std::setprecision(4) << point.serialFraction << "\n";
+    }
+    std::cout << "\nA serial fraction that grows with the thread count points at parallel overhead\n"
+              << "(frontier generation, scheduling, load imbalance) rather than inherently serial work.\n";
+    
+    std::ofstream csvFile("scaling_results.csv");
+    if (csvFile.is_open()) {
+        csvFile << "Mode,Puzzle,Threads,Placement,Work Units,Partition Depth,Repetitions,Median Time (ms),"
+                << "Time CI Low (ms),Time CI High (ms),Speedup,Efficiency (%),Karp-Flatt Serial Fraction,"
+                << "Allowed CPUs,Physical Cores,CPU,Compiler,Compile Flags\n";
+        for (const ScalingPoint& point : points) {
+            csvFile << point.mode << ","
+                    << point.puzzleName << ","
+                    << point.numThreads << ","
+                    << point.placement << ","
+                    << point.workUnits << ","
+                    << (point.mode == "strong" ? options.scalingDepth : 1) << ","
+                    << point.timing.repetitions << ","
+                    << std::fixed << std::setprecision(3) << point.timing.median << ","
+                    << point.timing.ciLow << ","
+                    << point.timing.ciHigh << ","
+                    << std::setprecision(4) << point.speedup << ","
+                    << std::setprecision(2) << point.efficiency << ","
+                    << std::setprecision(5) << point.serialFraction << ","
+                    << topology.cpus.size() << ","
+                    << topology.numCores << ","
+                    << csvQuote(system.cpuModel) << ","
+                    << csvQuote(system.compiler) << ","
+                    << csvQuote(system.compileFlags) << "\n";
+        }
+        csvFile.close();
+        std::cout << "\nScaling results saved to scaling_results.csv\n";
+    } else {
+        std::cerr << "Error: Could not create scaling CSV file\n";
+    }
+    
+    if (mismatches > 0) {
+        std::cout << "\nVerification: " << mismatches << " runs found the wrong number of solutions\n";
+    }
+    return mismatches;
 }
 
-int main() {
-    generatePerformanceReport();
-    return 0;
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace") {
+            options.trace = true;
+        } else if (arg == "--no-perf") {
+            options.perfCounters = false;
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.warmupRuns = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--reps" && i + 1 < argc) {
+            options.repetitions = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--confidence" && i + 1 < argc) {
+            options.confidence = std::stod(argv[++i]);
+            if (options.confidence <= 0.0 || options.confidence >= 1.0) {
+                std::cerr << "Error: --confidence must be between 0 and 1\n";
+                return 1;
+            }
+        } else if (arg == "--pin") {
+            options.pinThreads = true;
+        } else if (arg == "--numa") {
+            options.numaAware = true;
+        } else if (arg == "--corpus" && i + 1 < argc) {
+            options.corpusPath = argv[++i];
+        } else if (arg == "--size" && i + 1 < argc) {
+            options.sizes.push_back(std::stoi(argv[++i]));
+        } else if (arg == "--category" && i + 1 < argc) {
+            options.category = argv[++i];
+        } else if (arg == "--puzzle" && i + 1 < argc) {
+            options.puzzles.push_back(argv[++i]);
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            options.baselinePath = argv[++i];
+        } else if (arg == "--time-tolerance" && i + 1 < argc) {
+            options.timeTolerance = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--node-tolerance" && i + 1 < argc) {
+            options.nodeTolerance = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--min-compare-ms" && i + 1 < argc) {
+            options.minCompareMs = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--engine" && i + 1 < argc) {
+            std::string engine = argv[++i];
+            if (engine == "propagation") {
+                options.engine = SEARCH_PROPAGATION;
+            } else if (engine == "row-major") {
+                options.engine = SEARCH_ROW_MAJOR;
+            } else if (engine == "cdcl") {
+                options.engine = SEARCH_CDCL;
+            } else {
+                std::cerr << "Error: --engine must be row-major, propagation or cdcl\n";
+                return 1;
+            }
+        } else if (arg == "--scaling") {
+            options.scaling = true;
+        } else if (arg == "--max-threads" && i + 1 < argc) {
+            options.maxThreads = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--strong-puzzle" && i + 1 < argc) {
+            options.strongPuzzle = argv[++i];
+        } else if (arg == "--weak-puzzle" && i + 1 < argc) {
+            options.weakPuzzle = argv[++i];
+        } else if (arg == "--units" && i + 1 < argc) {
+            options.unitsPerThread = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--depth" && i + 1 < argc) {
+            options.scalingDepth = std::max(1, std::stoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--corpus FILE] [--size N]... [--category C] [--puzzle NAME]... [--trace] [--no-perf]"
+                      << " [--warmup N] [--reps N] [--confidence C] [--pin] [--numa] [--engine E]"
+                      << " [--baseline FILE] [--time-tolerance T] [--node-tolerance T] [--min-compare-ms MS]\n"
+                      << "       " << argv[0] << " --scaling [--max-threads N] [--strong-puzzle NAME]"
+                      << " [--weak-puzzle NAME] [--units N] [--depth D] [--numa]\n";
+            std::cerr << "  --corpus FILE    benchmark corpus (default " << SUDOKU_CORPUS_PATH << ")\n";
+            std::cerr << "  --size N         only puzzles of size N (repeatable)\n";
+            std::cerr << "  --category C     only puzzles of category C (easy, hard, pathological, multi)\n";
+            std::cerr << "  --puzzle NAME    only the corpus puzzle NAME (repeatable)\n";
+            std::cerr << "  --trace          write a Chrome trace (trace_*.json) of every parallel run\n";
+            std::cerr << "  --no-perf        do not read hardware performance counters\n";
+            std::cerr << "  --warmup N       untimed runs per configuration (default 1)\n";
+            std::cerr << "  --reps N         timed runs per configuration (default 5)\n";
+            std::cerr << "  --confidence C   level of the bootstrap intervals (default 0.95)\n";
+            std::cerr << "  --pin            pin OpenMP threads to CPUs\n";
+            std::cerr << "  --numa           optimized strategy: pin threads across NUMA nodes, per-node frontier shards\n";
+            std::cerr << "  --engine E       subproblem search of the optimized strategy: row-major (default), propagation or cdcl\n";
+            std::cerr << "  --baseline FILE  compare with an earlier performance_results.csv, exit 1 on regressions\n";
+            std::cerr << "  --time-tolerance T  allowed relative slowdown of the median time (default 0.10)\n";
+            std::cerr << "  --node-tolerance T  allowed relative increase of the node count (default 0)\n";
+            std::cerr << "  --min-compare-ms MS  do not judge times of configurations faster than this (default 1)\n";
+            std::cerr << "  --scaling        strong and weak scaling study, written to scaling_results.csv\n";
+            std::cerr << "  --max-threads N  largest thread count of the study (default hardware_concurrency)\n";
+            std::cerr << "  --strong-puzzle NAME  corpus puzzle of the strong scaling runs (default 9x9-pathological-sparse)\n";
+            std::cerr << "  --weak-puzzle NAME    corpus puzzle of the weak scaling batches (default 9x9-hard-inkala)\n";
+            std::cerr << "  --units N        weak scaling puzzles per thread (default 4)\n";
+            std::cerr << "  --depth D        partition depth of the strong scaling runs (default 3)\n";
+            return 1;
+        }
+    }
+    
+    int failures = options.scaling ? runScalingStudy(options) : generatePerformanceReport(options);
+    return (failures == 0) ? 0 : 1;
 }
@@ -0,0 +1,175 @@
+#include "puzzle_io.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+
+// Return N if count == N * N for a perfect-square N, otherwise 0
+static int boardSizeForCells(size_t count) {
+    int N = static_cast<int>(std::lround(std::sqrt(static_cast<double>(count))));
+    int blockSize = static_cast<int>(std::lround(std::sqrt(static_cast<double>(N))));
+    if (N <= 0 || static_cast<size_t>(N) * N != count || blockSize * blockSize != N) {
+        return 0;
+    }
+    return N;
+}
+
+// Parse one puzzle line
+bool parsePuzzleLine(const std::string& line, Puzzle& puzzle) {
+    bool hasSeparator = line.find_first_of(" \t,") != std::string::npos;
+    std::vector<int> values;
+
+    if (!hasSeparator) {
+        // Compact format: one character per cell
+        for (char ch : line) {
+            if (ch == '\r' || ch == '\n') {
+                continue;
+            }
+            if (ch == '.' || ch == '0') {
+                values.push_back(0);
+            } else if (ch >= '1' && ch <= '9') {
+                values.push_back(ch - '0');
+            } else {
+                return false;
+            }
+        }
+    } else {
+        // Token format: integers separated by spaces or commas
+        std::string normalized = line;
+        for (char& ch : normalized) {
+            if (ch == ',') {
+                ch = ' ';
+            }
+        }
+        std::istringstream tokens(normalized);
+        std::string token;
+        int shapeEnd = 0;
+        if (std::sscanf(normalized.c_str(), " %dx%d%n", &puzzle.blockRows, &puzzle.blockCols, &shapeEnd) == 2 &&
+            shapeEnd < static_cast<int>(normalized.size()) && (normalized[shapeEnd] == ' ' || normalized[shapeEnd] == '\t')) {
+            if (puzzle.blockRows < 1 || puzzle.blockCols < 1) {
+                return false;
+            }
+            tokens.seekg(static_cast<std::streamoff>(shapeEnd));
+        } else {
+            puzzle.blockRows = 0;
+            puzzle.blockCols = 0;
+        }
+        while (tokens >> token) {
+            if (token == ".") {
+                values.push_back(0);
+                continue;
+            }
+            char* end = nullptr;
+            long value = std::strtol(token.c_str(), &end, 10);
+            if (end == token.c_str() || *end != '\0' || value < 0) {
+                return false;
+            }
+            values.push_back(static_cast<int>(value));
+        }
+    }
+
+    int N = (puzzle.blockRows > 0) ? puzzle.blockRows * puzzle.blockCols : boardSizeForCells(values.size());
+    if (N == 0 || static_cast<size_t>(N) * N != values.size()) {
+        return false;
+    }
+    for (int value : values) {
+        if (value > N) {
+            return false;
+        }
+    }
+
+    puzzle.N = N;
+    puzzle.board = std::move(values);
+    return true;
+}
+
+// Load all puzzles from a file
+bool loadPuzzleFile(const std::string& path, std::vector<Puzzle>& puzzles, bool allowRectangular) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open puzzle file " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        Puzzle puzzle;
+        if (!parsePuzzleLine(line.substr(first), puzzle)) {
+            std::cerr << "Warning: " << path << ":" << lineNumber
+                      << ": not a valid puzzle, skipping" << std::endl;
+            continue;
+        }
+        if (puzzle.blockRows > 0 && !allowRectangular) {
+            std::cerr << "Warning: " << path << ":" << lineNumber
+                      << ": block shapes are not supported here, skipping" << std::endl;
+            continue;
+        }
+        puzzle.lineNumber = lineNumber;
+        puzzles.push_back(std::move(puzzle));
+    }
+
+    return true;
+}
+
+// Parse one corpus line
+bool parseCorpusLine(const std::string& line, CorpusEntry& entry) {
+    std::istringstream fields(line);
+    std::string expected;
+    if (!(fields >> entry.name >> entry.category >> expected)) {
+        return false;
+    }
+
+    char* end = nullptr;
+    entry.expectedSolutions = std::strtoll(expected.c_str(), &end, 10);
+    if (end == expected.c_str() || *end != '\0' || entry.expectedSolutions < 0) {
+        return false;
+    }
+
+    std::string rest;
+    std::getline(fields, rest);
+    size_t first = rest.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return false;
+    }
+    // The solvers of the benchmarks need square blocks
+    return parsePuzzleLine(rest.substr(first), entry.puzzle) && entry.puzzle.blockRows == 0;
+}
+
+// Load a benchmark corpus
+bool loadCorpusFile(const std::string& path, std::vector<CorpusEntry>& entries) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open corpus file " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        CorpusEntry entry;
+        if (!parseCorpusLine(line.substr(first), entry)) {
+            std::cerr << "Warning: " << path << ":" << lineNumber
+                      << ": not a valid corpus entry, skipping" << std::endl;
+            continue;
+        }
+        entry.puzzle.lineNumber = lineNumber;
+        entries.push_back(std::move(entry));
+    }
+
+    return true;
+}
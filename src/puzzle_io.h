@@ -0,0 +1,47 @@
+#ifndef PUZZLE_IO_H
+#define PUZZLE_IO_H
+
+#include <vector>
+#include <string>
+
+// A puzzle read from a text file
+struct Puzzle {
+    int N;                   // Size of the board (N x N)
+    std::vector<int> board;  // Flattened board, 0 for empty cells
+    int lineNumber;          // Line the puzzle was read from (1-based)
+    int blockRows;           // Block shape of a rectangular puzzle (0 = sqrt(N) x sqrt(N))
+    int blockCols;
+
+    Puzzle() : N(0), lineNumber(0), blockRows(0), blockCols(0) {}
+};
+
+// Parse one puzzle line. Two formats are accepted:
+//  - compact: N*N characters for N <= 9, digits 1..N, '0' or '.' for empty cells
+//  - tokens:  N*N integers separated by spaces or commas, '0' or '.' for empty cells
+// The token format may start with a block shape "<rows>x<cols>" (e.g. "2x3" for a
+// 6x6 board), which sets blockRows / blockCols and lifts the perfect-square rule.
+// Returns false if the line is not a valid puzzle of a perfect-square size, or of
+// the given block shape.
+bool parsePuzzleLine(const std::string& line, Puzzle& puzzle);
+
+// Load all puzzles from a file, one per line. Empty lines and lines starting
+// with '#' are skipped; malformed lines are reported and skipped, and so are puzzles
+// with rectangular blocks unless allowRectangular is set (only some modes support them).
+bool loadPuzzleFile(const std::string& path, std::vector<Puzzle>& puzzles, bool allowRectangular = false);
+
+// A benchmark puzzle with its known answer
+struct CorpusEntry {
+    std::string name;            // Unique puzzle name
+    std::string category;        // easy, hard, pathological or multi
+    long long expectedSolutions; // Number of solutions the solvers must find
+    Puzzle puzzle;
+};
+
+// Parse one corpus line: <name> <category> <expected solutions> <puzzle>, where
+// the puzzle is in either format accepted by parsePuzzleLine
+bool parseCorpusLine(const std::string& line, CorpusEntry& entry);
+
+// Load a benchmark corpus; comment and empty lines are skipped as in loadPuzzleFile
+bool loadCorpusFile(const std::string& path, std::vector<CorpusEntry>& entries);
+
+#endif // PUZZLE_IO_H
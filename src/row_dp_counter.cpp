@@ -0,0 +1,335 @@
+#include "row_dp_counter.h"
+#include "bit_utils.h"
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+#include <atomic>
+#include <omp.h>
+
+namespace {
+
+const int MAX_DP_SIZE = 16;
+const int KEY_WORDS = 5;    // 16-bit slots: N column masks then up to N block masks (20 slots max)
+
+// Column masks and current-band block masks, 16 bits per mask (bit v - 1 for value v)
+struct DpKey {
+    uint64_t words[KEY_WORDS];
+
+    bool operator==(const DpKey& other) const {
+        for (int i = 0; i < KEY_WORDS; ++i) {
+            if (words[i] != other.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+struct DpKeyHash {
+    size_t operator()(const DpKey& key) const {
+        uint64_t hash = 0x9E3779B97F4A7C15ull;
+        for (int i = 0; i < KEY_WORDS; ++i) {
+            hash ^= key.words[i];
+            hash *= 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 31;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+typedef std::unordered_map<DpKey, unsigned __int128, DpKeyHash> StateMap;
+
+uint16_t keySlot(const DpKey& key, int slot) {
+    return static_cast<uint16_t>(key.words[slot / 4] >> (16 * (slot % 4)));
+}
+
+void setKeySlot(DpKey& key, int slot, uint16_t mask) {
+    key.words[slot / 4] |= static_cast<uint64_t>(mask) << (16 * (slot % 4));
+}
+
+// Per-row constraints from the givens
+struct RowConstraints {
+    uint16_t rowGivens;                  // Values given in this row
+    uint16_t blockedCol[MAX_DP_SIZE];    // Per column: values given in later rows
+    uint16_t blockedBlock[MAX_DP_SIZE];  // Per stack: values given in later rows of this band
+};
+
+// Expansion of one state into all fillings of one row
+struct RowWalk {
+    int N;
+    int blockCols;
+    bool endOfBand;
+    const int* givens;              // The row's givens, 0 for empty cells
+    const RowConstraints* limits;
+    uint16_t cols[MAX_DP_SIZE];
+    uint16_t blocks[MAX_DP_SIZE];
+    unsigned __int128 multiplicity;
+    long long fillings;
+    std::vector<StateMap>* shards;  // Successor states, sharded by hash
+    unsigned __int128 completed;    // Last row: total instead of successor states
+
+    // States created by all threads in this row, checked against the limit in batches
+    // so that a growing row stops long before the merge
+    std::atomic<long long>* rowStates;
+    std::atomic<bool>* overLimit;
+    long long stateLimit;
+    long long unflushed;             // New states of this thread not yet in rowStates
+
+    void flushStates() {
+        if (rowStates->fetch_add(unflushed, std::memory_order_relaxed) + unflushed > stateLimit) {
+            overLimit->store(true, std::memory_order_relaxed);
+        }
+        unflushed = 0;
+    }
+
+    void fill(int col, uint16_t rowUsed) {
+        if (col == N) {
+            fillings++;
+            if (shards == nullptr) {
+                completed += multiplicity;
+                return;
+            }
+            DpKey key = {};
+            for (int c = 0; c < N; ++c) {
+                setKeySlot(key, c, cols[c]);
+            }
+            if (!endOfBand) {
+                for (int s = 0; s < N / blockCols; ++s) {
+                    setKeySlot(key, N + s, blocks[s]);
+                }
+            }
+            if (overLimit->load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::vector<StateMap>& target = *shards;
+            auto inserted = target[DpKeyHash()(key) % target.size()].emplace(key, 0);
+            inserted.first->second += multiplicity;
+            if (inserted.second && ++unflushed == 4096) {
+                flushStates();
+            }
+            return;
+        }
+        int stack = col / blockCols;
+        if (givens[col] != 0) {
+            uint16_t bit = static_cast<uint16_t>(1u << (givens[col] - 1));
+            cols[col] |= bit;
+            blocks[stack] |= bit;
+            fill(col + 1, rowUsed);
+            cols[col] &= static_cast<uint16_t>(~bit);
+            blocks[stack] &= static_cast<uint16_t>(~bit);
+            return;
+        }
+        uint32_t full = (1u << N) - 1;
+        uint32_t candidates = full & ~(cols[col] | blocks[stack] | rowUsed | limits->rowGivens |
+                                       limits->blockedCol[col] | limits->blockedBlock[stack]);
+        while (candidates != 0) {
+            uint16_t bit = static_cast<uint16_t>(candidates & (~candidates + 1));
+            candidates &= candidates - 1;
+            cols[col] |= bit;
+            blocks[stack] |= bit;
+            fill(col + 1, static_cast<uint16_t>(rowUsed | bit));
+            cols[col] &= static_cast<uint16_t>(~bit);
+            blocks[stack] &= static_cast<uint16_t>(~bit);
+        }
+    }
+};
+
+} // namespace
+
+RowDpCounter::RowDpCounter(int N, int numThreads)
+    : N(N), numThreads(std::max(1, numThreads)), stateLimit(20000000) {
+    blockRows = static_cast<int>(sqrt(N));
+    blockCols = blockRows;
+}
+
+bool RowDpCounter::setBlockShape(int rows, int cols) {
+    if (rows < 1 || cols < 1 || rows * cols != N) {
+        return false;
+    }
+    blockRows = rows;
+    blockCols = cols;
+    return true;
+}
+
+void RowDpCounter::setStateLimit(long long limit) {
+    stateLimit = limit;
+}
+
+bool RowDpCounter::count(const std::vector<int>& board, RowDpCount& result) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    result.solutions = 0;
+    result.rowFillings = 0;
+    result.totalStates = 0;
+    result.maxStates = 0;
+    result.timeMs = 0.0;
+
+    if (N > MAX_DP_SIZE || blockRows * blockCols != N || N + N / blockCols > 4 * KEY_WORDS ||
+        static_cast<int>(board.size()) != N * N) {
+        std::cerr << "Error: row DP counting needs N <= " << MAX_DP_SIZE
+                  << " and blocks that tile the board" << std::endl;
+        return false;
+    }
+    const int numStacks = N / blockCols;
+
+    // Validate the givens and record, per row, what later rows already use
+    std::vector<uint16_t> rowMasks(N, 0), colMasks(N, 0), blockMasks(N, 0);
+    for (int cell = 0; cell < N * N; ++cell) {
+        int value = board[cell];
+        if (value == 0) {
+            continue;
+        }
+        int row = cell / N;
+        int col = cell % N;
+        int block = (row / blockRows) * numStacks + col / blockCols;
+        if (value < 0 || value > N ||
+            ((rowMasks[row] | colMasks[col] | blockMasks[block]) & (1u << (value - 1)))) {
+            std::cerr << "Error: invalid or conflicting given at cell " << cell << std::endl;
+            return false;
+        }
+        uint16_t bit = static_cast<uint16_t>(1u << (value - 1));
+        rowMasks[row] |= bit;
+        colMasks[col] |= bit;
+        blockMasks[block] |= bit;
+    }
+    std::vector<RowConstraints> limits(N);
+    for (int row = N - 1; row >= 0; --row) {
+        RowConstraints& limit = limits[row];
+        limit.rowGivens = rowMasks[row];
+        for (int c = 0; c < N; ++c) {
+            limit.blockedCol[c] = (row + 1 < N) ? static_cast<uint16_t>(limits[row + 1].blockedCol[c]) : 0;
+        }
+        for (int s = 0; s < numStacks; ++s) {
+            bool lastOfBand = (row + 1) % blockRows == 0;
+            limit.blockedBlock[s] = lastOfBand ? 0 : static_cast<uint16_t>(limits[row + 1].blockedBlock[s]);
+        }
+        if (row + 1 < N) {
+            for (int c = 0; c < N; ++c) {
+                int value = board[(row + 1) * N + c];
+                if (value != 0 && (row + 1) % blockRows != 0) {
+                    limit.blockedBlock[c / blockCols] |= static_cast<uint16_t>(1u << (value - 1));
+                }
+                if (value != 0) {
+                    limit.blockedCol[c] |= static_cast<uint16_t>(1u << (value - 1));
+                }
+            }
+        }
+    }
+
+    std::vector<std::pair<DpKey, unsigned __int128>> frontier;
+    frontier.push_back(std::make_pair(DpKey{}, static_cast<unsigned __int128>(1)));
+
+    const int numShards = numThreads;
+    std::vector<std::vector<StateMap>> local(numThreads, std::vector<StateMap>(numShards));
+    std::vector<StateMap> merged(numShards);
+
+    for (int row = 0; row < N; ++row) {
+        bool lastRow = row == N - 1;
+        bool endOfBand = (row + 1) % blockRows == 0;
+        long long fillings = 0;
+        unsigned __int128 completed = 0;
+        int numStates = static_cast<int>(frontier.size());
+        std::atomic<long long> rowStates(0);
+        std::atomic<bool> overLimit(false);
+
+        #pragma omp parallel num_threads(numThreads) reduction(+:fillings)
+        {
+            int thread = omp_get_thread_num();
+            RowWalk walk;
+            walk.N = N;
+            walk.blockCols = blockCols;
+            walk.endOfBand = endOfBand;
+            walk.givens = &board[row * N];
+            walk.limits = &limits[row];
+            walk.fillings = 0;
+            walk.shards = lastRow ? nullptr : &local[thread];
+            walk.completed = 0;
+            walk.rowStates = &rowStates;
+            walk.overLimit = &overLimit;
+            walk.stateLimit = stateLimit;
+            walk.unflushed = 0;
+
+            #pragma omp for schedule(dynamic, 16)
+            for (int i = 0; i < numStates; ++i) {
+                if (overLimit.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+                const DpKey& key = frontier[i].first;
+                for (int c = 0; c < N; ++c) {
+                    walk.cols[c] = keySlot(key, c);
+                }
+                for (int s = 0; s < numStacks; ++s) {
+                    walk.blocks[s] = keySlot(key, N + s);
+                }
+                walk.multiplicity = frontier[i].second;
+                walk.fill(0, 0);
+                walk.flushStates();
+            }
+            fillings += walk.fillings;
+            #pragma omp critical
+            completed += walk.completed;
+
+            // Merge shard p of every thread into merged[p], largest map first
+            // (skipped when the row is abandoned)
+            #pragma omp for schedule(dynamic, 1)
+            for (int shard = 0; shard < numShards; ++shard) {
+                if (overLimit.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+                int largest = 0;
+                for (int t = 1; t < numThreads; ++t) {
+                    if (local[t][shard].size() > local[largest][shard].size()) {
+                        largest = t;
+                    }
+                }
+                merged[shard].swap(local[largest][shard]);
+                for (int t = 0; t < numThreads; ++t) {
+                    if (t == largest) {
+                        continue;
+                    }
+                    for (const auto& entry : local[t][shard]) {
+                        merged[shard][entry.first] += entry.second;
+                    }
+                    local[t][shard].clear();
+                }
+            }
+        }
+        result.rowFillings += fillings;
+        if (overLimit) {
+            std::cerr << "Error: more than " << stateLimit << " states while expanding row " << row + 1
+                      << "; stopped before the merge" << std::endl;
+            return false;
+        }
+
+        if (lastRow) {
+            result.solutions = completed;
+            break;
+        }
+
+        size_t nextSize = 0;
+        for (const StateMap& shard : merged) {
+            nextSize += shard.size();
+        }
+        frontier.clear();
+        frontier.reserve(nextSize);
+        for (StateMap& shard : merged) {
+            frontier.insert(frontier.end(), shard.begin(), shard.end());
+            shard.clear();
+        }
+        result.totalStates += static_cast<long long>(nextSize);
+        result.maxStates = std::max(result.maxStates, static_cast<long long>(nextSize));
+        if (static_cast<long long>(nextSize) > stateLimit) {
+            std::cerr << "Error: " << nextSize << " states after row " << row + 1
+                      << " exceed the limit of " << stateLimit << std::endl;
+            return false;
+        }
+        if (frontier.empty()) {
+            break;
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    result.timeMs = std::chrono::duration<double, std::milli>(end - start).count();
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef ROW_DP_COUNTER_H
+#define ROW_DP_COUNTER_H
+
+#include <vector>
+#include <cstdint>
+
+// Result of one row-by-row count
+struct RowDpCount {
+    unsigned __int128 solutions;
+    long long rowFillings;   // Row assignments generated across all states
+    long long totalStates;   // Distinct frontier states summed over rows
+    long long maxStates;     // Largest frontier (distinct states after one row)
+    double timeMs;
+};
+
+// Counts completions one row at a time. After each row only the column masks and
+// the masks of the blocks of the current band matter for the rows below, so all
+// partial grids with the same masks are merged into one frontier state with a
+// multiplicity. Each row's states are expanded in parallel; the successors are
+// hashed into one shard per thread and the shards are merged in parallel.
+// Supports N <= 16 and rectangular blocks (e.g. 2x3 for 6x6).
+class RowDpCounter {
+private:
+    int N;              // Size of the board (N x N)
+    int blockRows;      // Rows per block (rows per band)
+    int blockCols;      // Columns per block
+    int numThreads;
+    long long stateLimit;   // Give up once a row creates more states than this (counted per
+                            // thread while expanding, so before duplicates are merged)
+
+public:
+    RowDpCounter(int N, int numThreads);
+
+    // Use blockRows x blockCols blocks (default sqrt(N) x sqrt(N)); returns false
+    // unless blockRows * blockCols == N
+    bool setBlockShape(int blockRows, int blockCols);
+    void setStateLimit(long long limit);
+
+    // Count the completions of board (0 = empty cell). Returns false if the board is
+    // unsupported, the givens conflict or a frontier exceeds the state limit.
+    bool count(const std::vector<int>& board, RowDpCount& result) const;
+};
+
+#endif // ROW_DP_COUNTER_H
@@ -0,0 +1,119 @@
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include <vector>
+#include "perf_counters.h"
+
+// Search counters of one thread, padded to a cache line so that threads
+// updating their own entry never share a line
+struct alignas(64) ThreadStats {
+    long long nodesVisited;       // Values placed during search
+    long long backtracks;         // Placements whose subtree held no solution
+    long long deadEnds;           // Empty cells reached with no placeable value
+    long long propagations;       // Values forced by constraint propagation
+    long long subproblemsSolved;  // Parallel tasks completed by this thread
+    long long subproblemsStolen;  // Of those, tasks taken from another NUMA node's shard
+    double busyMs;                // Time spent solving tasks
+    double idleMs;                // Time inside the parallel region not solving
+    PerfCounts counters;          // Hardware counters while solving (if enabled)
+
+    ThreadStats()
+        : nodesVisited(0), backtracks(0), deadEnds(0), propagations(0),
+          subproblemsSolved(0), subproblemsStolen(0), busyMs(0.0), idleMs(0.0) {}
+
+    void add(const ThreadStats& other) {
+        nodesVisited += other.nodesVisited;
+        backtracks += other.backtracks;
+        deadEnds += other.deadEnds;
+        propagations += other.propagations;
+        subproblemsSolved += other.subproblemsSolved;
+        subproblemsStolen += other.subproblemsStolen;
+        busyMs += other.busyMs;
+        idleMs += other.idleMs;
+        counters.add(other.counters);
+    }
+};
+
+// Work done on one parallel task
+struct SubproblemRecord {
+    long long nodes;    // Search nodes visited
+    double durationMs;  // Wall time of the task
+    int thread;         // Thread that solved it
+
+    SubproblemRecord() : nodes(0), durationMs(0.0), thread(-1) {}
+};
+
+// Statistics of the last solve, one entry per thread
+struct SolverStats {
+    std::vector<ThreadStats> perThread;
+    std::vector<SubproblemRecord> subproblems;  // One record per task, in task order
+    double frontierMs;   // Time spent generating subproblems (serial)
+    int numSubproblems;  // Number of tasks handed to the parallel loop
+    PerfCounts frontierCounters;  // Hardware counters of subproblem generation (if enabled)
+    long long frontierBytes;      // Memory of the task list handed to the parallel loop
+    std::vector<int> threadCpus;   // CPU of every thread of a NUMA-aware run (empty otherwise)
+    std::vector<int> threadNodes;  // and its NUMA node (sysfs id)
+
+    SolverStats() : frontierMs(0.0), numSubproblems(0), frontierBytes(0) {}
+
+    void reset(int numThreads) {
+        perThread.assign(numThreads, ThreadStats());
+        subproblems.clear();
+        frontierMs = 0.0;
+        numSubproblems = 0;
+        frontierCounters = PerfCounts();
+        frontierBytes = 0;
+        threadCpus.clear();
+        threadNodes.clear();
+    }
+
+    ThreadStats total() const {
+        ThreadStats sum;
+        for (const ThreadStats& stats : perThread) {
+            sum.add(stats);
+        }
+        return sum;
+    }
+};
+
+// Stats policies for the search templates. NoStats compiles to nothing, so the
+// production search pays no cost; CollectStats counts in locals and is flushed
+// into the thread's ThreadStats once per task.
+struct NoStats {
+    void node() {}
+    void backtrack() {}
+    void deadEnd() {}
+    void propagation() {}
+    void add(long long, long long, long long, long long) {}
+    void flush(ThreadStats&) {}
+};
+
+struct CollectStats {
+    long long nodes = 0;
+    long long backtracks = 0;
+    long long deadEnds = 0;
+    long long propagations = 0;
+
+    void node() { ++nodes; }
+    void backtrack() { ++backtracks; }
+    void deadEnd() { ++deadEnds; }
+    void propagation() { ++propagations; }
+
+    // Counters of an engine that keeps its own (CdclSolver)
+    void add(long long moreNodes, long long moreBacktracks, long long moreDeadEnds, long long morePropagations) {
+        nodes += moreNodes;
+        backtracks += moreBacktracks;
+        deadEnds += moreDeadEnds;
+        propagations += morePropagations;
+    }
+
+    void flush(ThreadStats& stats) {
+        stats.nodesVisited += nodes;
+        stats.backtracks += backtracks;
+        stats.deadEnds += deadEnds;
+        stats.propagations += propagations;
+        nodes = backtracks = deadEnds = propagations = 0;
+    }
+};
+
+#endif // SOLVER_STATS_H
@@ -1,7 +1,19 @@
 #include "sudoku_solver.h"
+#include "candidate_kernels.h"
+#include "cdcl_solver.h"
+#include "checkpoint.h"
+#include "system_info.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <iomanip>
+#include <climits>
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <omp.h>
 
 // BitMaskState implementation
@@ -12,39 +24,52 @@ BitMaskState::BitMaskState(int N) {
 }
 
 void BitMaskState::set(int N, int blockSize, int row, int col, int value) {
-    // Validate value to prevent overflow (max value for uint32_t is 31)
-    if (value < 1 || value > 31) {
+    // Validate value to prevent overflow (max value for uint64_t is 63)
+    if (value < 1 || value > 63) {
         return;  // Invalid value, skip
     }
     int blockIdx = (row / blockSize) * blockSize + (col / blockSize);
-    rowMask[row] |= (1u << value);
-    colMask[col] |= (1u << value);
-    blockMask[blockIdx] |= (1u << value);
+    rowMask[row] |= (1ull << value);
+    colMask[col] |= (1ull << value);
+    blockMask[blockIdx] |= (1ull << value);
 }
 
 void BitMaskState::unset(int N, int blockSize, int row, int col, int value) {
     // Validate value to prevent overflow
-    if (value < 1 || value > 31) {
+    if (value < 1 || value > 63) {
         return;  // Invalid value, skip
     }
     int blockIdx = (row / blockSize) * blockSize + (col / blockSize);
-    rowMask[row] &= ~(1u << value);
-    colMask[col] &= ~(1u << value);
-    blockMask[blockIdx] &= ~(1u << value);
+    rowMask[row] &= ~(1ull << value);
+    colMask[col] &= ~(1ull << value);
+    blockMask[blockIdx] &= ~(1ull << value);
 }
 
 bool BitMaskState::canPlace(int N, int blockSize, int row, int col, int value) const {
     // Validate value to prevent overflow
-    if (value < 1 || value > 31) {
+    if (value < 1 || value > 63) {
         return false;  // Invalid value
     }
     int blockIdx = (row / blockSize) * blockSize + (col / blockSize);
-    uint32_t mask = (1u << value);
+    uint64_t mask = (1ull << value);
     return !(rowMask[row] & mask) && !(colMask[col] & mask) && !(blockMask[blockIdx] & mask);
 }
 
+// Bitmask of the values 1..N that can still be placed at (row, col)
+uint64_t BitMaskState::candidates(int N, int blockSize, int row, int col) const {
+    int blockIdx = (row / blockSize) * blockSize + (col / blockSize);
+    uint64_t fullMask = ((N >= 63) ? ~0ull : ((1ull << (N + 1)) - 1)) & ~1ull;
+    return fullMask & ~(rowMask[row] | colMask[col] | blockMask[blockIdx]);
+}
+
 // Constructor
-SudokuSolver::SudokuSolver(int N) : N(N), numSolutions(0), runningTime(0.0) {
+SudokuSolver::SudokuSolver(int N)
+    : N(N), numSolutions(0), runningTime(0.0),
+      progressEnabled(false), progressInterval(1.0), progressProbes(64), collectStats(false),
+      perfCounters(false), tracer(nullptr), searchEngine(SEARCH_ROW_MAJOR),
+      portfolioWinner(-1), numRestarts(0), gaveUp(false),
+      checkpointInterval(60.0), checkpointResume(true), lastRunComplete(true),
+      stopFlag(nullptr), numaAware(false) {
     blockSize = static_cast<int>(sqrt(N));
     
     // Validate that N is a perfect square
@@ -53,10 +78,10 @@ SudokuSolver::SudokuSolver(int N) : N(N), numSolutions(0), runningTime(0.0) {
                   << "Sudoku constraints may not work correctly." << std::endl;
     }
     
-    // Validate that N is within bitmask range (uint32_t supports up to 31)
-    if (N > 31) {
-        std::cerr << "Error: N=" << N << " exceeds maximum supported size of 31 "
-                  << "for bitmask optimization. Please use N <= 25." << std::endl;
+    // Validate that N is within bitmask range (uint64_t supports up to 63)
+    if (N > 63) {
+        std::cerr << "Error: N=" << N << " exceeds maximum supported size of 63 "
+                  << "for bitmask optimization. Please use N <= 49." << std::endl;
     }
     
     board.resize(N * N, 0);
@@ -170,7 +195,8 @@ std::set<int> SudokuSolver::getPossibleValues(int row, int col) const {
 }
 
 // Backtracking algorithm for single thread
-int SudokuSolver::backtrackSingleThread(int pos) {
+template <typename Stats>
+long long SudokuSolver::backtrackSingleThread(int pos, Stats& stats) {
     // If we've filled all cells, we found a solution
     if (pos == N * N) {
         return 1;
@@ -181,23 +207,34 @@ int SudokuSolver::backtrackSingleThread(int pos) {
     
     // Skip already filled cells
     if (board[getIndex(row, col)] != 0) {
-        return backtrackSingleThread(pos + 1);
+        return backtrackSingleThread(pos + 1, stats);
     }
     
-    int count = 0;
+    long long count = 0;
+    bool placedAny = false;
     for (int value = 1; value <= N; ++value) {
         if (isValid(row, col, value)) {
+            placedAny = true;
+            stats.node();
             board[getIndex(row, col)] = value;
-            count += backtrackSingleThread(pos + 1);
+            long long solutions = backtrackSingleThread(pos + 1, stats);
             board[getIndex(row, col)] = 0;  // Backtrack
+            if (solutions == 0) {
+                stats.backtrack();
+            }
+            count += solutions;
         }
     }
     
+    if (!placedAny) {
+        stats.deadEnd();
+    }
     return count;
 }
 
 // Solve from a given state (used by parallel solver)
-int SudokuSolver::solveFromState(const std::vector<int>& boardRef, int pos) {
+template <typename Stats>
+long long SudokuSolver::solveFromState(const std::vector<int>& boardRef, int pos, Stats& stats) {
     // If we've filled all cells, we found a solution
     if (pos == N * N) {
         return 1;
@@ -208,30 +245,74 @@ int SudokuSolver::solveFromState(const std::vector<int>& boardRef, int pos) {
     
     // Skip already filled cells
     if (boardRef[getIndex(row, col)] != 0) {
-        return solveFromState(boardRef, pos + 1);
+        return solveFromState(boardRef, pos + 1, stats);
     }
     
-    int count = 0;
+    long long count = 0;
+    bool placedAny = false;
     for (int value = 1; value <= N; ++value) {
         if (isValidWithBoard(boardRef, row, col, value)) {
+            placedAny = true;
+            stats.node();
             // Create a copy only when we need to modify
             // Note: This copy-per-recursion approach is necessary for thread safety
             // in the parallel solver, as each thread needs its own independent board state.
             // While memory-intensive, it ensures correctness in parallel execution.
             std::vector<int> boardCopy = boardRef;
             boardCopy[getIndex(row, col)] = value;
-            count += solveFromState(boardCopy, pos + 1);
+            long long solutions = solveFromState(boardCopy, pos + 1, stats);
+            if (solutions == 0) {
+                stats.backtrack();
+            }
+            count += solutions;
         }
     }
     
+    if (!placedAny) {
+        stats.deadEnd();
+    }
     return count;
 }
 
+// Run one parallel task; when threadStats is set, count with CollectStats and
+// record the task time (and, if given, fill the task's record), otherwise run the
+// zero-cost NoStats instantiation
+template <typename SolveFn>
+static long long runTask(ThreadStats* threadStats, SubproblemRecord* record, SolveFn solve) {
+    if (threadStats == nullptr) {
+        NoStats counters;
+        return solve(counters);
+    }
+
+    double taskStart = omp_get_wtime();
+    CollectStats counters;
+    long long solutions = solve(counters);
+    double taskMs = (omp_get_wtime() - taskStart) * 1000.0;
+    if (record != nullptr) {
+        record->nodes = counters.nodes;
+        record->durationMs = taskMs;
+        record->thread = omp_get_thread_num();
+    }
+    counters.flush(*threadStats);
+    threadStats->busyMs += taskMs;
+    threadStats->subproblemsSolved++;
+    return solutions;
+}
+
 // Single thread solving
 void SudokuSolver::solveSingleThread() {
     auto start = std::chrono::high_resolution_clock::now();
     
-    numSolutions = backtrackSingleThread(0);
+    lastStats.reset((collectStats || perfCounters) ? 1 : 0);
+    ThreadStats* threadStats = collectStats ? &lastStats.perThread[0] : nullptr;
+    PerfCounterGroup hardwareCounters;
+    if (perfCounters && hardwareCounters.open()) {
+        hardwareCounters.start();
+    }
+    numSolutions = runTask(threadStats, nullptr, [&](auto& counters) { return backtrackSingleThread(0, counters); });
+    if (hardwareCounters.isOpen()) {
+        lastStats.perThread[0].counters = hardwareCounters.stop();
+    }
     
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> duration = end - start;
@@ -243,6 +324,8 @@ void SudokuSolver::solveParallel(int numThreads) {
     auto start = std::chrono::high_resolution_clock::now();
     
     omp_set_num_threads(numThreads);
+    lastStats.reset((collectStats || perfCounters) ? numThreads : 0);
+    double frontierStart = tracer ? tracer->nowUs() : 0.0;
     
     // Find first empty cell
     int firstRow = -1, firstCol = -1;
@@ -271,22 +354,67 @@ void SudokuSolver::solveParallel(int numThreads) {
     std::set<int> possibleValues = getPossibleValues(firstRow, firstCol);
     std::vector<int> valuesList(possibleValues.begin(), possibleValues.end());
     
-    int totalSolutions = 0;
+    long long totalSolutions = 0;
     int numValues = static_cast<int>(valuesList.size());
     
+    lastStats.numSubproblems = numValues;
+    if (collectStats) {
+        lastStats.subproblems.resize(numValues);
+        lastStats.frontierBytes = static_cast<long long>(valuesList.capacity() * sizeof(int));
+    }
+    if (tracer) {
+        tracer->record(0, "frontier", "setup", frontierStart, tracer->nowUs(), numValues);
+    }
+    
     // Parallel loop over possible values
-    #pragma omp parallel for reduction(+:totalSolutions)
-    for (int i = 0; i < numValues; ++i) {
-        int value = valuesList[i];
+    #pragma omp parallel
+    {
+        int thread = omp_get_thread_num();
+        double regionStart = omp_get_wtime();
+        ThreadStats* threadStats = collectStats ? &lastStats.perThread[thread] : nullptr;
+        long long threadSolutions = 0;
+        PerfCounterGroup hardwareCounters;
+        if (perfCounters && hardwareCounters.open()) {
+            hardwareCounters.start();
+        }
         
-        // Create a copy of the board for this thread
-        std::vector<int> boardCopy = board;
-        boardCopy[getIndex(firstRow, firstCol)] = value;
+        #pragma omp for nowait
+        for (int i = 0; i < numValues; ++i) {
+            TraceScope task(tracer, thread, "subproblem", "solve", i);
+            
+            int value = valuesList[i];
+            
+            // Create a copy of the board for this thread
+            std::vector<int> boardCopy = board;
+            boardCopy[getIndex(firstRow, firstCol)] = value;
+            
+            // Solve from this state
+            int pos = getIndex(firstRow, firstCol) + 1;
+            SubproblemRecord* record = collectStats ? &lastStats.subproblems[i] : nullptr;
+            threadSolutions += runTask(threadStats, record, [&](auto& counters) {
+                return solveFromState(boardCopy, pos, counters);
+            });
+        }
+
+        if (hardwareCounters.isOpen()) {
+            lastStats.perThread[thread].counters = hardwareCounters.stop();
+        }
+
+        // Combine the per-thread counts (explicitly, so the step shows up in the trace)
+        {
+            TraceScope reduce(tracer, thread, "reduce", "sync");
+            #pragma omp atomic
+            totalSolutions += threadSolutions;
+        }
+        {
+            TraceScope wait(tracer, thread, "barrier", "sync");
+            #pragma omp barrier
+        }
         
-        // Solve from this state
-        int pos = getIndex(firstRow, firstCol) + 1;
-        int solutions = solveFromState(boardCopy, pos);
-        totalSolutions += solutions;
+        // Time waiting at the barrier counts as idle
+        if (threadStats != nullptr) {
+            threadStats->idleMs = (omp_get_wtime() - regionStart) * 1000.0 - threadStats->busyMs;
+        }
     }
     
     numSolutions = totalSolutions;
@@ -296,8 +424,37 @@ void SudokuSolver::solveParallel(int numThreads) {
     runningTime = duration.count();
 }
 
+// Enable or disable per-thread search statistics
+void SudokuSolver::setCollectStats(bool enabled) {
+    collectStats = enabled;
+}
+
+// Statistics of the last solve (empty when collection is disabled)
+const SolverStats& SudokuSolver::getStats() const {
+    return lastStats;
+}
+
+// Enable or disable hardware performance counters
+void SudokuSolver::setPerfCounters(bool enabled) {
+    perfCounters = enabled;
+}
+
+// Attach a timeline recorder to the parallel solvers
+void SudokuSolver::setTracer(Tracer* tracer) {
+    this->tracer = tracer;
+}
+
+// Select the search used for subproblems
+void SudokuSolver::setSearchEngine(SearchEngine engine) {
+    searchEngine = engine;
+}
+
+SearchEngine SudokuSolver::getSearchEngine() const {
+    return searchEngine;
+}
+
 // Query methods
-int SudokuSolver::getNumSolutions() const {
+long long SudokuSolver::getNumSolutions() const {
     return numSolutions;
 }
 
@@ -342,7 +499,8 @@ void SudokuSolver::printBoard() const {
 }
 
 // Optimized backtracking with bitmask for validation
-int SudokuSolver::backtrackWithBitmask(std::vector<int>& boardRef, BitMaskState& state, int pos) {
+template <typename Stats>
+long long SudokuSolver::backtrackWithBitmask(std::vector<int>& boardRef, BitMaskState& state, int pos, Stats& stats) {
     // If we've filled all cells, we found a solution
     if (pos == N * N) {
         return 1;
@@ -353,33 +511,625 @@ int SudokuSolver::backtrackWithBitmask(std::vector<int>& boardRef, BitMaskState&
     
     // Skip already filled cells
     if (boardRef[getIndex(row, col)] != 0) {
-        return backtrackWithBitmask(boardRef, state, pos + 1);
+        return backtrackWithBitmask(boardRef, state, pos + 1, stats);
+    }
+
+    // A stopped checkpointed run abandons the subproblem (its partial count is discarded)
+    if (stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed)) {
+        return 0;
     }
     
-    int count = 0;
+    long long count = 0;
+    bool placedAny = false;
     for (int value = 1; value <= N; ++value) {
         if (state.canPlace(N, blockSize, row, col, value)) {
+            placedAny = true;
+            stats.node();
             boardRef[getIndex(row, col)] = value;
             state.set(N, blockSize, row, col, value);
             
-            count += backtrackWithBitmask(boardRef, state, pos + 1);
+            long long solutions = backtrackWithBitmask(boardRef, state, pos + 1, stats);
             
             boardRef[getIndex(row, col)] = 0;
             state.unset(N, blockSize, row, col, value);
+            if (solutions == 0) {
+                stats.backtrack();
+            }
+            count += solutions;
         }
     }
     
+    if (!placedAny) {
+        stats.deadEnd();
+    }
+    return count;
+}
+
+// Search with constraint propagation. Each node recomputes the candidates of all
+// cells in one pass, classifies them with scanCandidates and places every naked single (a cell with one candidate).
+// When there are none, it places the hidden singles (a digit with one possible
+// cell in a row, column or block) and fails on a digit with no cell left in a
+// unit. This repeats until nothing is forced; then the search branches on the
+// empty cell with the fewest candidates (MRV). Forced placements are undone
+// through the trail on return. candidates is scratch space of N * N + 6 * N
+// entries (cell masks, then the per-unit once / seen masks) shared by all
+// levels: a node reads it only before recursing. singles (N * N entries) is shared
+// the same way.
+template <typename Stats>
+long long SudokuSolver::searchWithPropagation(std::vector<int>& boardRef, BitMaskState& state,
+                                              std::vector<uint64_t>& candidates, std::vector<int>& singles,
+                                              std::vector<int>& trail, Stats& stats) {
+    const int numCells = N * N;
+    if (stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    const size_t trailMark = trail.size();
+    long long count = 0;
+    int branchCell = -1;
+    uint64_t branchMask = 0;
+
+    while (true) {
+        computeAllCandidates(boardRef.data(), N, blockSize, state.rowMask.data(), state.colMask.data(),
+                             state.blockMask.data(), candidates.data());
+
+        CandidateScan scan;
+        scanCandidates(candidates.data(), boardRef.data(), numCells, singles.data(), scan);
+        bool anyEmpty = scan.numEmpty > 0;
+        bool forced = false;
+        bool contradiction = scan.contradiction >= 0;
+        if (!contradiction) {
+            branchCell = scan.branchCell;
+            branchMask = (branchCell >= 0) ? candidates[branchCell] : 0;
+        }
+        for (int i = 0; i < scan.numSingles && !contradiction; ++i) {
+            // A single placed earlier in this pass may have taken the value
+            int cell = singles[i];
+            int row = cell / N;
+            int col = cell % N;
+            int value = lowestBit64(candidates[cell]);
+            if (!state.canPlace(N, blockSize, row, col, value)) {
+                contradiction = true;
+                break;
+            }
+            boardRef[cell] = value;
+            state.set(N, blockSize, row, col, value);
+            trail.push_back(cell);
+            stats.propagation();
+            forced = true;
+        }
+
+        if (!contradiction && anyEmpty && !forced) {
+            // Hidden singles and digits without a cell, for all 3N units at once
+            uint64_t* once = candidates.data() + numCells;
+            uint64_t* seen = once + 3 * N;
+            findHiddenSingles(candidates.data(), N, blockSize, once, seen);
+            const uint64_t fullMask = ((N >= 63) ? ~0ull : ((1ull << (N + 1)) - 1)) & ~1ull;
+
+            for (int unit = 0; unit < 3 * N && !contradiction; ++unit) {
+                uint64_t placed = (unit < N) ? state.rowMask[unit]
+                                : (unit < 2 * N) ? state.colMask[unit - N] : state.blockMask[unit - 2 * N];
+                if (fullMask & ~(placed | seen[unit])) {
+                    contradiction = true;
+                    break;
+                }
+                for (uint64_t mask = once[unit] & ~placed; mask != 0; mask &= mask - 1) {
+                    int value = lowestBit64(mask);
+                    uint64_t bit = 1ull << value;
+                    int cell = -1;
+                    for (int i = 0; i < N; ++i) {
+                        int candidateCell = unitCell(N, blockSize, unit, i);
+                        if (candidates[candidateCell] & bit) {
+                            cell = candidateCell;
+                            break;
+                        }
+                    }
+                    // The cell may have been filled by a single of another unit in this pass
+                    if (boardRef[cell] == value) {
+                        continue;
+                    }
+                    int row = cell / N;
+                    int col = cell % N;
+                    if (boardRef[cell] != 0 || !state.canPlace(N, blockSize, row, col, value)) {
+                        contradiction = true;
+                        break;
+                    }
+                    boardRef[cell] = value;
+                    state.set(N, blockSize, row, col, value);
+                    trail.push_back(cell);
+                    stats.propagation();
+                    forced = true;
+                }
+            }
+        }
+
+        if (contradiction) {
+            stats.deadEnd();
+            branchCell = -1;
+            break;
+        }
+        if (!anyEmpty) {
+            count = 1;
+            branchCell = -1;
+            break;
+        }
+        if (!forced) {
+            break;
+        }
+    }
+
+    if (branchCell >= 0) {
+        int row = branchCell / N;
+        int col = branchCell % N;
+        for (uint64_t mask = branchMask; mask != 0; mask &= mask - 1) {
+            int value = lowestBit64(mask);
+            stats.node();
+            boardRef[branchCell] = value;
+            state.set(N, blockSize, row, col, value);
+
+            long long solutions = searchWithPropagation(boardRef, state, candidates, singles, trail, stats);
+
+            boardRef[branchCell] = 0;
+            state.unset(N, blockSize, row, col, value);
+            if (solutions == 0) {
+                stats.backtrack();
+            }
+            count += solutions;
+        }
+    }
+
+    // Undo the forced placements of this node
+    while (trail.size() > trailMark) {
+        int cell = trail.back();
+        trail.pop_back();
+        state.unset(N, blockSize, cell / N, cell % N, boardRef[cell]);
+        boardRef[cell] = 0;
+    }
     return count;
 }
 
+// Progress of one first-solution search
+struct QuerySearch {
+    const SearchConfig& config;
+    SplitMix64 rng;
+    long long limit;                     // Stop after this many solutions
+    long long found;
+    std::vector<int> solution;           // First solution found
+    const std::atomic<bool>* cancelled;  // Set when another search answered first (may be null)
+    bool aborted;                        // Stopped by cancellation before finishing
+    long long nodeBudget;                // Nodes left in the current run
+    bool outOfBudget;                    // The current run was cut off for a restart
+    long long restarts;
+    long long nodesLeft;                 // Nodes left before giving up (config.nodeLimit)
+    bool gaveUp;
+    std::vector<uint64_t> scratch;       // MRV: N * N cell masks, then once / seen of the 3N units
+
+    QuerySearch(const SearchConfig& config, long long limit, const std::atomic<bool>* cancelled)
+        : config(config), rng(config.seed), limit(limit), found(0), cancelled(cancelled), aborted(false),
+          nodeBudget(LLONG_MAX), outOfBudget(false), restarts(0),
+          nodesLeft(config.nodeLimit > 0 ? config.nodeLimit : LLONG_MAX), gaveUp(false) {}
+
+    bool checkCancelled() {
+        if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed)) {
+            aborted = true;
+        }
+        return aborted;
+    }
+};
+
+// Stable sort of values by ascending key[value] (insertion sort, at most 64 values)
+static void sortValuesByKey(uint8_t* values, int numValues, const uint8_t* key) {
+    for (int i = 1; i < numValues; ++i) {
+        uint8_t value = values[i];
+        int j = i;
+        for (; j > 0 && key[values[j - 1]] > key[value]; --j) {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+}
+
+// Least-constraining value first: key[v] = empty peers of cell whose candidates
+// include v, i.e. the candidates that placing v removes
+static void orderLeastConstraining(uint8_t* values, int numValues, uint64_t mask,
+                                   const std::vector<int>& boardRef, const BitMaskState& state,
+                                   int N, int blockSize, int cell) {
+    uint8_t key[64] = {};
+    int row = cell / N;
+    int col = cell % N;
+    auto countPeer = [&](int peerRow, int peerCol) {
+        if (boardRef[peerRow * N + peerCol] == 0) {
+            uint64_t shared = state.candidates(N, blockSize, peerRow, peerCol) & mask;
+            for (; shared != 0; shared &= shared - 1) {
+                ++key[lowestBit64(shared)];
+            }
+        }
+    };
+    for (int i = 0; i < N; ++i) {
+        if (i != col) {
+            countPeer(row, i);
+        }
+        if (i != row) {
+            countPeer(i, col);
+        }
+    }
+    int blockRow = row - row % blockSize;
+    int blockCol = col - col % blockSize;
+    for (int r = blockRow; r < blockRow + blockSize; ++r) {
+        for (int c = blockCol; c < blockCol + blockSize; ++c) {
+            if (r != row && c != col) {
+                countPeer(r, c);
+            }
+        }
+    }
+    sortValuesByKey(values, numValues, key);
+}
+
+// Least-placed value first: key[v] = rows that already contain v
+static void orderLeastPlaced(uint8_t* values, int numValues, uint64_t mask, const BitMaskState& state, int N) {
+    uint8_t key[64] = {};
+    for (int row = 0; row < N; ++row) {
+        for (uint64_t placed = state.rowMask[row] & mask; placed != 0; placed &= placed - 1) {
+            ++key[lowestBit64(placed)];
+        }
+    }
+    sortValuesByKey(values, numValues, key);
+}
+
+// Bitmask search with the cell and value order of search.config that stops after
+// search.limit solutions or when cancelled. The first solution is copied out.
+template <typename Stats>
+void SudokuSolver::searchConfigured(std::vector<int>& boardRef, BitMaskState& state, int pos,
+                                    QuerySearch& search, Stats& stats) {
+    if (search.checkCancelled()) {
+        return;
+    }
+    if (--search.nodeBudget < 0) {
+        search.outOfBudget = true;
+        return;
+    }
+    if (--search.nodesLeft < 0) {
+        search.gaveUp = search.aborted = true;
+        return;
+    }
+
+    int cell = -1;
+    uint64_t mask = 0;
+    if (search.config.cellOrder == CELL_ROW_MAJOR) {
+        while (pos < N * N && boardRef[pos] != 0) {
+            ++pos;
+        }
+        if (pos < N * N) {
+            cell = pos;
+            mask = state.candidates(N, blockSize, pos / N, pos % N);
+        }
+    } else {
+        // Fewest candidates; a tie replaces the choice with probability 1 / ties
+        uint64_t* candidates = search.scratch.data();
+        int fewest = N + 1;
+        uint32_t ties = 0;
+        for (int candidateCell = 0; candidateCell < N * N && fewest > 0; ++candidateCell) {
+            if (boardRef[candidateCell] != 0) {
+                candidates[candidateCell] = 0;
+                continue;
+            }
+            uint64_t candidateMask = state.candidates(N, blockSize, candidateCell / N, candidateCell % N);
+            candidates[candidateCell] = candidateMask;
+            int count = popcount64(candidateMask);
+            if (count < fewest) {
+                fewest = count;
+                cell = candidateCell;
+                mask = candidateMask;
+                ties = 1;
+            } else if (count == fewest && search.rng.below(++ties) == 0) {
+                cell = candidateCell;
+                mask = candidateMask;
+            }
+        }
+
+        if (fewest >= 2 && fewest <= N) {
+            uint64_t* once = candidates + N * N;
+            uint64_t* seen = once + 3 * N;
+            findHiddenSingles(candidates, N, blockSize, once, seen);
+            const uint64_t fullMask = ((N >= 63) ? ~0ull : ((1ull << (N + 1)) - 1)) & ~1ull;
+            for (int unit = 0; unit < 3 * N; ++unit) {
+                uint64_t placed = (unit < N) ? state.rowMask[unit]
+                                : (unit < 2 * N) ? state.colMask[unit - N] : state.blockMask[unit - 2 * N];
+                if (fullMask & ~(placed | seen[unit])) {
+                    stats.deadEnd();
+                    return;
+                }
+                uint64_t singles = once[unit] & ~placed;
+                if (singles != 0) {
+                    uint64_t bit = singles & (~singles + 1);
+                    for (int i = 0; i < N; ++i) {
+                        int unitMember = unitCell(N, blockSize, unit, i);
+                        if (candidates[unitMember] & bit) {
+                            cell = unitMember;
+                            mask = bit;
+                            break;
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (cell < 0) {
+        if (search.found == 0) {
+            search.solution = boardRef;
+        }
+        ++search.found;
+        return;
+    }
+    if (mask == 0) {
+        stats.deadEnd();
+        return;
+    }
+
+    uint8_t values[64];
+    int numValues = 0;
+    for (uint64_t remaining = mask; remaining != 0; remaining &= remaining - 1) {
+        values[numValues++] = static_cast<uint8_t>(lowestBit64(remaining));
+    }
+    if (numValues > 1) {
+        switch (search.config.valueOrder) {
+            case VALUE_ASCENDING:
+                break;
+            case VALUE_DESCENDING:
+                std::reverse(values, values + numValues);
+                break;
+            case VALUE_RANDOM:
+                for (int i = numValues - 1; i > 0; --i) {
+                    std::swap(values[i], values[search.rng.below(i + 1)]);
+                }
+                break;
+            case VALUE_LEAST_CONSTRAINING:
+                orderLeastConstraining(values, numValues, mask, boardRef, state, N, blockSize, cell);
+                break;
+            case VALUE_LEAST_PLACED:
+                orderLeastPlaced(values, numValues, mask, state, N);
+                break;
+        }
+    }
+
+    int row = cell / N;
+    int col = cell % N;
+    for (int i = 0; i < numValues && search.found < search.limit && !search.aborted && !search.outOfBudget; ++i) {
+        int value = values[i];
+        stats.node();
+        boardRef[cell] = value;
+        state.set(N, blockSize, row, col, value);
+
+        long long before = search.found;
+        searchConfigured(boardRef, state, cell + 1, search, stats);
+
+        boardRef[cell] = 0;
+        state.unset(N, blockSize, row, col, value);
+        if (search.found == before) {
+            stats.backtrack();
+        }
+    }
+}
+
+// Find up to search.limit solutions with the clause learning solver. Each model
+// found is excluded by a clause over its placements before the next solve; the
+// learned clauses stay valid and are kept. A cancellable search solves in slices
+// of 1000 conflicts and checks for cancellation in between. Decisions count as
+// nodes, conflicts as dead ends, undone decision levels as backtracks and implied
+// literals as propagations.
+template <typename Stats>
+void SudokuSolver::solveWithCdcl(const std::vector<int>& boardRef, QuerySearch& search, Stats& stats) {
+    CdclSolver cdcl;
+    SudokuCnf cnf;
+    if (encodeSudoku(boardRef.data(), N, blockSize, cdcl, cnf)) {
+        if (search.config.seed != 0) {
+            cdcl.randomizeOrder(search.config.seed);
+        }
+        const long long conflictSlice = (search.cancelled != nullptr) ? 1000 : -1;
+        std::vector<int> blocking;
+        while (search.found < search.limit) {
+            CdclResult result = CDCL_UNKNOWN;
+            while (result == CDCL_UNKNOWN && !search.checkCancelled()) {
+                result = cdcl.solve(conflictSlice);
+            }
+            if (result != CDCL_SATISFIABLE) {
+                break;
+            }
+            blocking.clear();
+            for (int var = 0; var < cdcl.numVariables(); ++var) {
+                if (cdcl.modelValue(var)) {
+                    blocking.push_back(CdclSolver::negative(var));
+                }
+            }
+            if (search.found++ == 0) {
+                search.solution = boardRef;
+                for (int var = 0; var < cdcl.numVariables(); ++var) {
+                    if (cdcl.modelValue(var)) {
+                        search.solution[cnf.cellOf[var]] = cnf.valueOf[var];
+                    }
+                }
+            }
+            // A board without empty cells has a single, empty model
+            if (!cdcl.addClause(blocking)) {
+                break;
+            }
+        }
+    }
+    const CdclStats& cdclStats = cdcl.getStats();
+    stats.add(cdclStats.decisions, cdclStats.backjumpLevels, cdclStats.conflicts, cdclStats.propagations);
+}
+
+// Node budget of restart run number run (from 0)
+static long long restartBudget(const SearchConfig& config, int N, int run) {
+    long long unit = (config.restartUnit > 0) ? config.restartUnit : 4LL * N * N;
+    if (config.restarts == RESTART_LUBY) {
+        return lubyTerm(run) * unit;
+    }
+    double budget = unit * std::pow(1.5, run);
+    return (budget < 1e18) ? static_cast<long long>(budget) : LLONG_MAX;
+}
+
+// Answer a query on the loaded board. A bitmask search for one solution with a
+// restart schedule is cut off after each run's node budget and started over
+// from the root; the search unwinds its placements on the way out.
+template <typename Stats>
+void SudokuSolver::runQuery(QuerySearch& search, Stats& stats) {
+    if (search.config.cdcl) {
+        solveWithCdcl(board, search, stats);
+        return;
+    }
+    std::vector<int> boardCopy = board;
+    BitMaskState state(N);
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (board[cell] != 0) {
+            state.set(N, blockSize, cell / N, cell % N, board[cell]);
+        }
+    }
+    if (search.config.cellOrder == CELL_MRV) {
+        search.scratch.assign(N * N + 6 * N, 0);
+    }
+    bool restarting = (search.config.restarts != RESTART_NONE && search.limit == 1);
+    for (int run = 0; ; ++run) {
+        search.nodeBudget = restarting ? restartBudget(search.config, N, run) : LLONG_MAX;
+        search.outOfBudget = false;
+        searchConfigured(boardCopy, state, 0, search, stats);
+        if (!search.outOfBudget || search.aborted) {
+            break;
+        }
+        ++search.restarts;
+    }
+}
+
 // Solve a subproblem (used by optimized parallel solver)
-int SudokuSolver::solveSubproblem(const Subproblem& subproblem) {
+template <typename Stats>
+long long SudokuSolver::solveSubproblem(const Subproblem& subproblem, Stats& stats) {
     // Create copies for thread safety - each thread needs independent state
     // Note: While this involves copying, it's necessary for parallel correctness
     // and only happens once per subproblem (not at every recursion level)
     std::vector<int> boardCopy = subproblem.board;
     BitMaskState stateCopy = subproblem.state;
-    return backtrackWithBitmask(boardCopy, stateCopy, subproblem.startPos);
+    if (searchEngine == SEARCH_PROPAGATION) {
+        std::vector<uint64_t> candidates(N * N + 6 * N);
+        std::vector<int> singles(N * N);
+        std::vector<int> trail;
+        trail.reserve(N * N);
+        return searchWithPropagation(boardCopy, stateCopy, candidates, singles, trail, stats);
+    }
+    if (searchEngine == SEARCH_CDCL) {
+        static const SearchConfig counting("cdcl", true, CELL_ROW_MAJOR, VALUE_ASCENDING, 0);
+        QuerySearch search(counting, LLONG_MAX, stopFlag);
+        solveWithCdcl(boardCopy, search, stats);
+        return search.found;
+    }
+    return backtrackWithBitmask(boardCopy, stateCopy, subproblem.startPos, stats);
+}
+
+// Memory held by a subproblem, including its heap buffers
+size_t Subproblem::bytes() const {
+    return sizeof(Subproblem) + board.capacity() * sizeof(int)
+         + (state.rowMask.capacity() + state.colMask.capacity() + state.blockMask.capacity()) * sizeof(uint64_t);
+}
+
+// Solve a subproblem without statistics
+long long SudokuSolver::solveSubproblem(const Subproblem& subproblem) {
+    NoStats stats;
+    return solveSubproblem(subproblem, stats);
+}
+
+// First-solution and uniqueness queries
+void SudokuSolver::solveFirst(long long maxSolutions) {
+    bool cdcl = (searchEngine == SEARCH_CDCL);
+    SearchConfig config(cdcl ? "cdcl" : "row-major", cdcl, CELL_ROW_MAJOR, VALUE_ASCENDING, 0);
+    solveFirst(config, maxSolutions);
+}
+
+void SudokuSolver::solveFirst(const SearchConfig& config, long long maxSolutions) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    lastStats.reset(collectStats ? 1 : 0);
+    ThreadStats* threadStats = collectStats ? &lastStats.perThread[0] : nullptr;
+    QuerySearch search(config, maxSolutions, nullptr);
+    numSolutions = runTask(threadStats, nullptr, [&](auto& counters) {
+        runQuery(search, counters);
+        return search.found;
+    });
+    solution.swap(search.solution);
+    numRestarts = search.restarts;
+    gaveUp = search.gaveUp;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    runningTime = duration.count();
+}
+
+const std::vector<int>& SudokuSolver::getSolution() const {
+    return solution;
+}
+
+// Race the configurations; the first search to finish answers and cancels the rest
+void SudokuSolver::solvePortfolio(const std::vector<SearchConfig>& configs, long long maxSolutions) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    int numConfigs = static_cast<int>(configs.size());
+    lastStats.reset(collectStats ? numConfigs : 0);
+    solution.clear();
+    numSolutions = 0;
+    numRestarts = 0;
+    std::atomic<bool> answered(false);
+    std::atomic<int> winner(-1);
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(std::max(1, numConfigs))
+    for (int i = 0; i < numConfigs; ++i) {
+        ThreadStats* threadStats = collectStats ? &lastStats.perThread[i] : nullptr;
+        QuerySearch search(configs[i], maxSolutions, &answered);
+        long long found = runTask(threadStats, nullptr, [&](auto& counters) {
+            runQuery(search, counters);
+            return search.found;
+        });
+        int expected = -1;
+        if (!search.aborted && winner.compare_exchange_strong(expected, i)) {
+            answered.store(true, std::memory_order_relaxed);
+            numSolutions = found;
+            solution.swap(search.solution);
+            numRestarts = search.restarts;
+        }
+    }
+    portfolioWinner = winner.load();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    runningTime = duration.count();
+}
+
+int SudokuSolver::getPortfolioWinner() const {
+    return portfolioWinner;
+}
+
+long long SudokuSolver::getNumRestarts() const {
+    return numRestarts;
+}
+
+bool SudokuSolver::queryGaveUp() const {
+    return gaveUp;
+}
+
+std::vector<SearchConfig> defaultPortfolio(int numConfigs, uint64_t seed) {
+    std::vector<SearchConfig> configs;
+    configs.push_back(SearchConfig("mrv-ascending", false, CELL_MRV, VALUE_ASCENDING, seed));
+    configs.push_back(SearchConfig("cdcl", true, CELL_ROW_MAJOR, VALUE_ASCENDING, 0));
+    configs.push_back(SearchConfig("mrv-random-luby", false, CELL_MRV, VALUE_RANDOM, seed + 1, RESTART_LUBY));
+    configs.push_back(SearchConfig("row-major-ascending", false, CELL_ROW_MAJOR, VALUE_ASCENDING, seed));
+    configs.push_back(SearchConfig("mrv-descending", false, CELL_MRV, VALUE_DESCENDING, seed + 2));
+    configs.push_back(SearchConfig("cdcl-shuffled", true, CELL_ROW_MAJOR, VALUE_ASCENDING, seed + 3));
+    configs.push_back(SearchConfig("row-major-random", false, CELL_ROW_MAJOR, VALUE_RANDOM, seed + 4));
+    // Further members differ only in the seed
+    for (int i = static_cast<int>(configs.size()); i < numConfigs; ++i) {
+        configs.push_back(SearchConfig("mrv-random", false, CELL_MRV, VALUE_RANDOM, seed + i));
+    }
+    configs.resize(std::max(1, std::min(numConfigs, static_cast<int>(configs.size()))),
+                   configs[0]);
+    return configs;
 }
 
 // Recursively generate subproblems by filling K empty cells
@@ -447,6 +1197,59 @@ void SudokuSolver::generateSubproblems(int partitionDepth, std::vector<Subproble
     generateSubproblemsRecursive(initial, 0, partitionDepth, subproblems);
 }
 
+// Set by SIGINT / SIGTERM during a checkpointed solveParallelOptimized run. A
+// lock-free atomic may be stored from a signal handler and read by every thread.
+static std::atomic<bool> stopRequested(false);
+static_assert(std::atomic<bool>::is_always_lock_free, "stopRequested must be lock-free");
+
+static void requestStop(int) {
+    stopRequested.store(true, std::memory_order_relaxed);
+}
+
+// Bookkeeping of a checkpointed run: the subproblems finished before it (from the
+// checkpoint it resumed) and the state of each subproblem of this run
+struct RunCheckpoint {
+    Checkpoint base;
+    std::vector<int> ids;              // Original frontier index of each subproblem
+    std::vector<char> finished;
+    std::vector<long long> counts;
+
+    // Snapshot of the current state; unfinished subproblems (including those in
+    // progress) are written as pending
+    bool write(const std::string& path, const std::vector<Subproblem>& subproblems) const {
+        Checkpoint snapshot;
+        snapshot.N = base.N;
+        snapshot.board = base.board;
+        snapshot.partitionDepth = base.partitionDepth;
+        snapshot.numSubproblems = base.numSubproblems;
+        snapshot.completedIds = base.completedIds;
+        snapshot.completedCounts = base.completedCounts;
+        snapshot.totalSolutions = base.totalSolutions;
+        for (size_t i = 0; i < subproblems.size(); ++i) {
+            if (finished[i]) {
+                snapshot.completedIds.push_back(ids[i]);
+                snapshot.completedCounts.push_back(counts[i]);
+                snapshot.totalSolutions += counts[i];
+            } else {
+                PendingSubproblem subproblem;
+                subproblem.id = ids[i];
+                subproblem.startPos = subproblems[i].startPos;
+                subproblem.board = subproblems[i].board;
+                snapshot.pending.push_back(subproblem);
+            }
+        }
+        return writeCheckpoint(path, snapshot);
+    }
+};
+
+// Subproblems of one NUMA node in a NUMA-aware run. The copies are made by a thread
+// of the node, so their pages are first touched (and placed) there.
+struct alignas(64) FrontierShard {
+    std::vector<int> ids;           // Index of each copy in the run's frontier
+    std::vector<Subproblem> local;
+    std::atomic<int> next{0};       // Next copy to hand out
+};
+
 // Optimized parallel solver with configurable partition depth
 void SudokuSolver::solveParallelOptimized(int numThreads, int partitionDepth) {
     auto start = std::chrono::high_resolution_clock::now();
@@ -454,30 +1257,447 @@ void SudokuSolver::solveParallelOptimized(int numThreads, int partitionDepth) {
     omp_set_num_threads(numThreads);
     
     // Generate subproblems
+    double frontierStart = omp_get_wtime();
+    double traceFrontierStart = tracer ? tracer->nowUs() : 0.0;
+    PerfCounterGroup frontierCounters;
+    if (perfCounters && frontierCounters.open()) {
+        frontierCounters.start();
+    }
     std::vector<Subproblem> subproblems;
-    generateSubproblems(partitionDepth, subproblems);
+    bool checkpointing = !checkpointPath.empty();
+    RunCheckpoint run;
+    lastRunComplete = true;
+    if (checkpointing && checkpointResume && std::ifstream(checkpointPath).good()) {
+        if (!resumeCheckpoint(run.base, subproblems, run.ids)) {
+            lastRunComplete = false;
+            numSolutions = 0;
+            runningTime = 0.0;
+            return;
+        }
+        std::cerr << "[checkpoint] resuming " << checkpointPath << ": " << run.base.completedIds.size()
+                  << " of " << run.base.numSubproblems << " subproblems done, "
+                  << run.base.totalSolutions << " solutions so far" << std::endl;
+    } else {
+        generateSubproblems(partitionDepth, subproblems);
+        run.base.N = N;
+        run.base.board = board;
+        run.base.partitionDepth = partitionDepth;
+        run.base.numSubproblems = static_cast<int>(subproblems.size());
+        run.base.totalSolutions = 0;
+        for (int i = 0; i < run.base.numSubproblems; ++i) {
+            run.ids.push_back(i);
+        }
+    }
+    PerfCounts frontierCounts = frontierCounters.stop();
+    if (tracer) {
+        tracer->record(0, "frontier", "setup", traceFrontierStart, tracer->nowUs(),
+                       static_cast<long long>(subproblems.size()));
+    }
     
+    lastStats.reset((collectStats || perfCounters) ? numThreads : 0);
+    lastStats.frontierMs = (omp_get_wtime() - frontierStart) * 1000.0;
+    lastStats.frontierCounters = frontierCounts;
+    lastStats.numSubproblems = static_cast<int>(subproblems.size());
+    if (collectStats) {
+        lastStats.subproblems.resize(subproblems.size());
+        long long frontierBytes = static_cast<long long>((subproblems.capacity() - subproblems.size()) * sizeof(Subproblem));
+        for (const Subproblem& subproblem : subproblems) {
+            frontierBytes += static_cast<long long>(subproblem.bytes());
+        }
+        lastStats.frontierBytes = frontierBytes;
+    }
+    
+    run.finished.assign(subproblems.size(), 0);
+    run.counts.assign(subproblems.size(), 0);
+
     if (subproblems.empty()) {
-        numSolutions = 0;
+        numSolutions = run.base.totalSolutions;
+        if (checkpointing) {
+            run.write(checkpointPath, subproblems);
+        }
         auto end = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double, std::milli> duration = end - start;
         runningTime = duration.count();
         return;
     }
     
-    int totalSolutions = 0;
+    long long totalSolutions = run.base.totalSolutions;
     int numSubproblems = static_cast<int>(subproblems.size());
+
+    // A signal only sets a flag; the searches poll it, threads stop taking
+    // subproblems and a final checkpoint is written after the parallel region
+    stopRequested.store(false);
+    void (*previousInt)(int) = SIG_DFL;
+    void (*previousTerm)(int) = SIG_DFL;
+    if (checkpointing) {
+        previousInt = std::signal(SIGINT, requestStop);
+        previousTerm = std::signal(SIGTERM, requestStop);
+        stopFlag = &stopRequested;
+    }
+    double lastCheckpoint = omp_get_wtime();
     
+    // Estimate the work in each subproblem so progress is measured in nodes, not tasks
+    std::vector<double> estimatedNodes;
+    double totalEstimate = 0.0;
+    if (progressEnabled) {
+        TraceScope estimate(tracer, 0, "estimate", "setup", numSubproblems);
+        estimatedNodes.resize(numSubproblems);
+        #pragma omp parallel for reduction(+:totalEstimate) schedule(dynamic)
+        for (int i = 0; i < numSubproblems; ++i) {
+            SplitMix64 rng(static_cast<uint64_t>(i) + 1);
+            const Subproblem& subproblem = subproblems[i];
+            estimatedNodes[i] = 1.0 + estimateFromState(subproblem.board, subproblem.state,
+                                                         subproblem.startPos, progressProbes, rng).nodes;
+            totalEstimate += estimatedNodes[i];
+        }
+        std::cerr << "[progress] " << numSubproblems << " subproblems, estimated "
+                  << totalEstimate << " search nodes" << std::endl;
+    }
+
+    double completedEstimate = 0.0;
+    int completedSubproblems = 0;
+    double progressStart = omp_get_wtime();
+    double lastReport = progressStart;
+
+    // NUMA-aware runs deal the subproblems round robin into one shard per node
+    ThreadPlacement placement;
+    std::vector<FrontierShard> shards;
+    if (numaAware) {
+        placement = placeThreads(numThreads);
+        shards = std::vector<FrontierShard>(placement.nodeIds.size());
+        for (int i = 0; i < numSubproblems; ++i) {
+            shards[i % shards.size()].ids.push_back(i);
+        }
+        if (!lastStats.perThread.empty()) {
+            lastStats.threadCpus = placement.cpus;
+            for (int node : placement.nodes) {
+                lastStats.threadNodes.push_back(placement.nodeIds[node]);
+            }
+        }
+    }
+
+    // Checkpoints are also written by a timer, so a run whose subproblems are long
+    // still saves every checkpointInterval (subproblems in progress are written as
+    // pending). The mutex guards run and lastCheckpoint against the solving threads.
+    std::mutex checkpointMutex;
+    std::condition_variable checkpointWake;
+    bool regionDone = false;
+    std::thread checkpointTimer;
+    if (checkpointing && checkpointInterval > 0.0) {
+        checkpointTimer = std::thread([&]() {
+            std::unique_lock<std::mutex> lock(checkpointMutex);
+            while (!regionDone) {
+                double wait = lastCheckpoint + checkpointInterval - omp_get_wtime();
+                if (wait > 0.0) {
+                    checkpointWake.wait_for(lock, std::chrono::duration<double>(wait));
+                    continue;
+                }
+                lastCheckpoint = omp_get_wtime();
+                run.write(checkpointPath, subproblems);
+            }
+        });
+    }
+
     // Parallel loop over subproblems
-    #pragma omp parallel for reduction(+:totalSolutions) schedule(dynamic)
-    for (int i = 0; i < numSubproblems; ++i) {
-        int solutions = solveSubproblem(subproblems[i]);
-        totalSolutions += solutions;
+    #pragma omp parallel
+    {
+        int thread = omp_get_thread_num();
+        double regionStart = omp_get_wtime();
+        ThreadStats* threadStats = collectStats ? &lastStats.perThread[thread] : nullptr;
+        long long threadSolutions = 0;
+        PerfCounterGroup hardwareCounters;
+        if (perfCounters && hardwareCounters.open()) {
+            hardwareCounters.start();
+        }
+
+        auto solveTask = [&](int i, const Subproblem& subproblem) {
+            if (stopRequested) {
+                return;
+            }
+            TraceScope task(tracer, thread, "subproblem", "solve", i);
+            SubproblemRecord* record = collectStats ? &lastStats.subproblems[i] : nullptr;
+            long long count = runTask(threadStats, record, [&](auto& counters) {
+                return solveSubproblem(subproblem, counters);
+            });
+            // The search returns early once a stop is requested, so a count that may
+            // be partial is dropped and the subproblem stays pending
+            if (stopRequested) {
+                return;
+            }
+            threadSolutions += count;
+
+            if (checkpointing) {
+                std::lock_guard<std::mutex> lock(checkpointMutex);
+                run.finished[i] = 1;
+                run.counts[i] = count;
+                double now = omp_get_wtime();
+                if (now - lastCheckpoint >= checkpointInterval) {
+                    lastCheckpoint = now;
+                    run.write(checkpointPath, subproblems);
+                }
+            }
+
+            if (progressEnabled) {
+                #pragma omp critical(progress)
+                {
+                    completedEstimate += estimatedNodes[i];
+                    ++completedSubproblems;
+                    double now = omp_get_wtime();
+                    if (now - lastReport >= progressInterval) {
+                        lastReport = now;
+                        printProgress(completedEstimate / totalEstimate, completedSubproblems,
+                                      numSubproblems, now - progressStart);
+                    }
+                }
+            }
+        };
+
+        // Affinity before pinning, restored at the end of the region
+        std::vector<int> previousCpus;
+        if (numaAware) {
+            // Pin first so the copies below come from memory of this thread's node
+            int node = placement.nodes[thread];
+            previousCpus = getCurrentThreadCpus();
+            pinCurrentThread(placement.cpus[thread]);
+            // Thread t is the first thread of node t (a smaller team copies the rest too)
+            for (size_t owned = thread; owned < shards.size(); owned += omp_get_num_threads()) {
+                FrontierShard& shard = shards[owned];
+                shard.local.reserve(shard.ids.size());
+                for (int i : shard.ids) {
+                    shard.local.push_back(subproblems[i]);
+                }
+            }
+            #pragma omp barrier
+
+            // Own shard first, then the other nodes nearest first
+            for (int step = 0; step < static_cast<int>(shards.size()); ++step) {
+                FrontierShard& shard = shards[step == 0 ? node : placement.stealOrder[node][step - 1]];
+                int size = static_cast<int>(shard.ids.size());
+                for (int k = shard.next.fetch_add(1); k < size; k = shard.next.fetch_add(1)) {
+                    solveTask(shard.ids[k], shard.local[k]);
+                    if (step > 0 && threadStats != nullptr) {
+                        ++threadStats->subproblemsStolen;
+                    }
+                }
+            }
+        } else {
+            #pragma omp for schedule(dynamic) nowait
+            for (int i = 0; i < numSubproblems; ++i) {
+                solveTask(i, subproblems[i]);
+            }
+        }
+
+        if (hardwareCounters.isOpen()) {
+            lastStats.perThread[thread].counters = hardwareCounters.stop();
+        }
+
+        // Combine the per-thread counts (explicitly, so the step shows up in the trace)
+        {
+            TraceScope reduce(tracer, thread, "reduce", "sync");
+            #pragma omp atomic
+            totalSolutions += threadSolutions;
+        }
+        {
+            TraceScope wait(tracer, thread, "barrier", "sync");
+            #pragma omp barrier
+        }
+
+        // Time waiting at the barrier counts as idle
+        if (threadStats != nullptr) {
+            threadStats->idleMs = (omp_get_wtime() - regionStart) * 1000.0 - threadStats->busyMs;
+        }
+
+        // Unpin the master and the pool threads so later regions of the caller are
+        // not confined to this run's placement
+        if (!previousCpus.empty()) {
+            setCurrentThreadCpus(previousCpus);
+        }
+    }
+
+    if (checkpointTimer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(checkpointMutex);
+            regionDone = true;
+        }
+        checkpointWake.notify_one();
+        checkpointTimer.join();
     }
     
     numSolutions = totalSolutions;
+
+    if (checkpointing) {
+        std::signal(SIGINT, previousInt);
+        std::signal(SIGTERM, previousTerm);
+        stopFlag = nullptr;
+        run.write(checkpointPath, subproblems);
+        if (stopRequested) {
+            lastRunComplete = false;
+            int remaining = static_cast<int>(std::count(run.finished.begin(), run.finished.end(), 0));
+            std::cerr << "[checkpoint] stopped by signal; " << remaining << " of " << run.base.numSubproblems
+                      << " subproblems left in " << checkpointPath << std::endl;
+        }
+    }
     
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> duration = end - start;
     runningTime = duration.count();
 }
+
+// Load a checkpoint of the current puzzle and rebuild its pending subproblems
+bool SudokuSolver::resumeCheckpoint(Checkpoint& checkpoint, std::vector<Subproblem>& subproblems,
+                                    std::vector<int>& ids) const {
+    if (!readCheckpoint(checkpointPath, checkpoint)) {
+        return false;
+    }
+    if (checkpoint.N != N || checkpoint.board != board) {
+        std::cerr << "Error: Checkpoint " << checkpointPath << " belongs to a different puzzle" << std::endl;
+        return false;
+    }
+    for (const PendingSubproblem& pending : checkpoint.pending) {
+        Subproblem subproblem(N);
+        subproblem.board = pending.board;
+        subproblem.startPos = pending.startPos;
+        for (int cell = 0; cell < N * N; ++cell) {
+            if (subproblem.board[cell] != 0) {
+                subproblem.state.set(N, blockSize, cell / N, cell % N, subproblem.board[cell]);
+            }
+        }
+        subproblems.push_back(subproblem);
+        ids.push_back(pending.id);
+    }
+    // The pending subproblems are rewritten by every checkpoint of this run
+    checkpoint.pending.clear();
+    return true;
+}
+
+// Enable checkpointing of solveParallelOptimized
+void SudokuSolver::setCheckpointing(const std::string& path, double intervalSeconds, bool resume) {
+    checkpointPath = path;
+    checkpointInterval = intervalSeconds;
+    checkpointResume = resume;
+}
+
+bool SudokuSolver::isComplete() const {
+    return lastRunComplete;
+}
+
+// Enable NUMA-aware thread placement and frontier sharding
+void SudokuSolver::setNumaAware(bool enabled) {
+    numaAware = enabled;
+}
+
+
+// One random probe down the bitmask search tree (Knuth's estimator). Each level
+// multiplies the path weight by the branching factor; the sum of the weights is an
+// unbiased estimate of the node count, and the weight at a full board estimates
+// the number of solutions.
+void SudokuSolver::probeSearchTree(std::vector<int>& boardRef, BitMaskState& state, int pos, SplitMix64& rng,
+                                   double& nodes, double& solutions, long long& steps) const {
+    int values[64];
+    double weight = 1.0;
+    nodes = 0.0;
+    solutions = 0.0;
+
+    while (true) {
+        // Same cell order as backtrackWithBitmask: next empty cell in row-major order
+        while (pos < N * N && boardRef[pos] != 0) {
+            pos++;
+        }
+        if (pos == N * N) {
+            solutions = weight;
+            return;
+        }
+
+        int row = pos / N;
+        int col = pos % N;
+        int numValues = 0;
+        for (int value = 1; value <= N; ++value) {
+            if (state.canPlace(N, blockSize, row, col, value)) {
+                values[numValues++] = value;
+            }
+        }
+        ++steps;
+
+        if (numValues == 0) {
+            return;  // Dead end
+        }
+
+        weight *= numValues;
+        nodes += weight;
+
+        int value = values[rng.below(numValues)];
+        boardRef[pos] = value;
+        state.set(N, blockSize, row, col, value);
+    }
+}
+
+// Average several probes from a given search state
+TreeSizeEstimate SudokuSolver::estimateFromState(const std::vector<int>& boardRef, const BitMaskState& state,
+                                                 int pos, int numProbes, SplitMix64& rng) const {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    double sumNodes = 0.0;
+    double sumNodesSquared = 0.0;
+    double sumSolutions = 0.0;
+    long long steps = 0;
+
+    for (int probe = 0; probe < numProbes; ++probe) {
+        std::vector<int> boardCopy = boardRef;
+        BitMaskState stateCopy = state;
+        double nodes = 0.0;
+        double solutions = 0.0;
+        probeSearchTree(boardCopy, stateCopy, pos, rng, nodes, solutions, steps);
+        sumNodes += nodes;
+        sumNodesSquared += nodes * nodes;
+        sumSolutions += solutions;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+
+    TreeSizeEstimate estimate;
+    estimate.numProbes = numProbes;
+    estimate.nodes = (numProbes > 0) ? sumNodes / numProbes : 0.0;
+    estimate.solutions = (numProbes > 0) ? sumSolutions / numProbes : 0.0;
+    double variance = (numProbes > 1)
+        ? std::max(0.0, (sumNodesSquared - numProbes * estimate.nodes * estimate.nodes) / (numProbes - 1))
+        : 0.0;
+    estimate.nodesStdError = (numProbes > 0) ? std::sqrt(variance / numProbes) : 0.0;
+    estimate.nsPerProbeStep = (steps > 0) ? duration.count() / steps : 0.0;
+    return estimate;
+}
+
+// Estimate the size of the search tree for the loaded board
+TreeSizeEstimate SudokuSolver::estimateSearchTree(int numProbes, uint64_t seed) const {
+    BitMaskState state(N);
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < N; ++col) {
+            int value = board[getIndex(row, col)];
+            if (value != 0) {
+                state.set(N, blockSize, row, col, value);
+            }
+        }
+    }
+
+    SplitMix64 rng(seed);
+    return estimateFromState(board, state, 0, numProbes, rng);
+}
+
+// Enable or disable progress reporting
+void SudokuSolver::setProgressReporting(bool enabled, double intervalSeconds, int probesPerSubproblem) {
+    progressEnabled = enabled;
+    progressInterval = intervalSeconds;
+    progressProbes = std::max(1, probesPerSubproblem);
+}
+
+// Print one progress line with an ETA extrapolated from the completed share of work
+void SudokuSolver::printProgress(double fraction, int completed, int total, double elapsedSeconds) const {
+    fraction = std::min(std::max(fraction, 0.0), 1.0);
+    std::cerr << "[progress] " << std::fixed << std::setprecision(1) << fraction * 100.0 << "% (est.), "
+              << completed << "/" << total << " subproblems, elapsed "
+              << std::setprecision(1) << elapsedSeconds << " s";
+    if (fraction > 0.0) {
+        std::cerr << ", ETA " << elapsedSeconds * (1.0 - fraction) / fraction << " s";
+    }
+    std::cerr << std::defaultfloat << std::endl;
+}
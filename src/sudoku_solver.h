@@ -4,18 +4,25 @@
 #include <vector>
 #include <chrono>
 #include <set>
+#include <string>
 #include <cstdint>
+#include <atomic>
+#include "bit_utils.h"
+#include "solver_stats.h"
+#include "tracer.h"
 
 // Structure to hold bitmask state for faster validation
+// Bit v of a mask is set when value v is already used (values 1..63)
 struct BitMaskState {
-    std::vector<uint32_t> rowMask;
-    std::vector<uint32_t> colMask;
-    std::vector<uint32_t> blockMask;
+    std::vector<uint64_t> rowMask;
+    std::vector<uint64_t> colMask;
+    std::vector<uint64_t> blockMask;
     
     BitMaskState(int N);
     void set(int N, int blockSize, int row, int col, int value);
     void unset(int N, int blockSize, int row, int col, int value);
     bool canPlace(int N, int blockSize, int row, int col, int value) const;
+    uint64_t candidates(int N, int blockSize, int row, int col) const;
 };
 
 // Structure representing a subproblem for parallel execution
@@ -25,6 +32,75 @@ struct Subproblem {
     int startPos;
     
     Subproblem(int N) : board(), state(N), startPos(0) {}
+
+    // Memory held by this subproblem, including its heap buffers
+    size_t bytes() const;
+};
+
+// Search used for the subproblems of solveParallelOptimized
+enum SearchEngine {
+    SEARCH_ROW_MAJOR,    // Fill the empty cells in row-major order (default)
+    SEARCH_PROPAGATION,  // Place naked and hidden singles, then branch on the cell with the fewest candidates
+    SEARCH_CDCL          // Clause encoding solved by CdclSolver; further solutions are excluded by blocking clauses
+};
+
+// Cell chosen for branching by the configurable first-solution search
+enum CellOrder {
+    CELL_ROW_MAJOR,  // Next empty cell in row-major order
+    CELL_MRV         // Empty cell with the fewest candidates, ties broken at random; without
+                     // naked singles, a hidden single (value with one cell left in a unit) goes first
+};
+
+// Order in which that search tries the values of a cell
+enum ValueOrder {
+    VALUE_ASCENDING,
+    VALUE_DESCENDING,
+    VALUE_RANDOM,    // Shuffled at every node
+    VALUE_LEAST_CONSTRAINING,  // Value that the fewest empty peers still have as a candidate first
+    VALUE_LEAST_PLACED         // Value with the fewest placements on the board first
+};
+
+// Node budgets after which a first-solution bitmask search starts over
+enum RestartSchedule {
+    RESTART_NONE,
+    RESTART_LUBY,        // restartUnit times 1 1 2 1 1 2 4 1 1 2 ...
+    RESTART_GEOMETRIC    // restartUnit times 1.5^run
+};
+
+// One configuration of the first-solution search, e.g. a portfolio member
+struct SearchConfig {
+    std::string name;
+    bool cdcl;              // Clause learning instead of the bitmask search (orders unused)
+    CellOrder cellOrder;
+    ValueOrder valueOrder;
+    uint64_t seed;          // Random tie-breaks and shuffles; initial CDCL variable order
+    RestartSchedule restarts;  // Only for bitmask searches with maxSolutions = 1
+    long long restartUnit;     // Nodes of the first run (0 = 4 * N * N)
+    long long nodeLimit;       // Bitmask search gives up after this many nodes in total (0 = no limit)
+
+    SearchConfig(const std::string& name, bool cdcl, CellOrder cellOrder, ValueOrder valueOrder, uint64_t seed,
+                 RestartSchedule restarts = RESTART_NONE, long long restartUnit = 0)
+        : name(name), cdcl(cdcl), cellOrder(cellOrder), valueOrder(valueOrder), seed(seed),
+          restarts(restarts), restartUnit(restartUnit), nodeLimit(0) {}
+};
+
+// A mix of numConfigs heterogeneous configurations (CDCL, MRV and row-major cell
+// orders, fixed and shuffled value orders, different seeds)
+std::vector<SearchConfig> defaultPortfolio(int numConfigs, uint64_t seed = 1);
+
+// Progress of one first-solution search (defined in sudoku_solver.cpp)
+struct QuerySearch;
+
+// Saved state of a solveParallelOptimized run (checkpoint.h)
+struct Checkpoint;
+
+// Monte Carlo (Knuth) estimate of the size of the bitmask search tree
+struct TreeSizeEstimate {
+    double nodes;            // Estimated number of nodes (value placements)
+    double nodesStdError;    // Standard error of the node estimate
+    double solutions;        // Estimated number of solutions
+    int numProbes;           // Number of random probes
+    double nsPerProbeStep;   // Measured cost of one probe step, for rough time predictions
 };
 
 class SudokuSolver {
@@ -32,9 +108,40 @@ private:
     int N;              // Size of the board (N x N)
     int blockSize;      // Size of each block (sqrt(N))
     std::vector<int> board;  // Flattened board representation
-    int numSolutions;   // Number of solutions found
+    long long numSolutions;  // Number of solutions found
     double runningTime; // Time taken to solve (in milliseconds)
 
+    // Progress reporting for long solveParallelOptimized runs
+    bool progressEnabled;
+    double progressInterval;  // Minimum seconds between progress lines
+    int progressProbes;       // Random probes per subproblem for the work estimate
+
+    // Per-thread search statistics of the last solve
+    bool collectStats;
+    bool perfCounters;  // Count hardware events per thread (Linux perf_event_open)
+    SolverStats lastStats;
+
+    // Optional timeline recorder for the parallel solvers (not owned)
+    Tracer* tracer;
+
+    SearchEngine searchEngine;
+
+    // First solution found by the last solveFirst / solvePortfolio (empty if none)
+    std::vector<int> solution;
+    int portfolioWinner;  // Configuration that answered the last solvePortfolio
+    long long numRestarts;  // Restarts of the search that answered the last query
+    bool gaveUp;            // The last solveFirst hit its node limit
+
+    // Checkpointing of solveParallelOptimized (disabled while checkpointPath is empty)
+    std::string checkpointPath;
+    double checkpointInterval;  // Minimum seconds between checkpoints
+    bool checkpointResume;      // Continue from an existing checkpoint of the same puzzle
+    bool lastRunComplete;       // False if the last solveParallelOptimized stopped early
+    const std::atomic<bool>* stopFlag;  // Polled by the subproblem searches (null = never stop)
+
+    // Pin threads and shard the solveParallelOptimized frontier per NUMA node
+    bool numaAware;
+
     // Helper methods
     int getIndex(int row, int col) const;
     bool isInRow(int row, int value) const;
@@ -44,16 +151,41 @@ private:
     bool isValidWithBoard(const std::vector<int>& boardRef, int row, int col, int value) const;
     bool findNextEmptyCell(int& row, int& col) const;
     std::set<int> getPossibleValues(int row, int col) const;
-    int backtrackSingleThread(int pos);
-    int solveFromState(const std::vector<int>& boardRef, int pos);
+
+    // Search routines are templated on a stats policy (NoStats / CollectStats)
+    template <typename Stats>
+    long long backtrackSingleThread(int pos, Stats& stats);
+    template <typename Stats>
+    long long solveFromState(const std::vector<int>& boardRef, int pos, Stats& stats);
     
     // Optimized methods with bitmask
-    int backtrackWithBitmask(std::vector<int>& boardRef, BitMaskState& state, int pos);
-    int solveSubproblem(const Subproblem& subproblem);
-    void generateSubproblems(int partitionDepth, std::vector<Subproblem>& subproblems);
+    template <typename Stats>
+    long long backtrackWithBitmask(std::vector<int>& boardRef, BitMaskState& state, int pos, Stats& stats);
+    template <typename Stats>
+    long long searchWithPropagation(std::vector<int>& boardRef, BitMaskState& state,
+                                    std::vector<uint64_t>& candidates, std::vector<int>& singles,
+                                    std::vector<int>& trail, Stats& stats);
+    template <typename Stats>
+    void searchConfigured(std::vector<int>& boardRef, BitMaskState& state, int pos,
+                          QuerySearch& search, Stats& stats);
+    template <typename Stats>
+    void solveWithCdcl(const std::vector<int>& boardRef, QuerySearch& search, Stats& stats);
+    template <typename Stats>
+    void runQuery(QuerySearch& search, Stats& stats);
+    template <typename Stats>
+    long long solveSubproblem(const Subproblem& subproblem, Stats& stats);
     void generateSubproblemsRecursive(Subproblem& current, int depth, int maxDepth, 
                                      std::vector<Subproblem>& results);
 
+    // Search-tree size estimation
+    void probeSearchTree(std::vector<int>& boardRef, BitMaskState& state, int pos, SplitMix64& rng,
+                         double& nodes, double& solutions, long long& steps) const;
+    TreeSizeEstimate estimateFromState(const std::vector<int>& boardRef, const BitMaskState& state,
+                                       int pos, int numProbes, SplitMix64& rng) const;
+    void printProgress(double fraction, int completed, int total, double elapsedSeconds) const;
+    bool resumeCheckpoint(Checkpoint& checkpoint, std::vector<Subproblem>& subproblems,
+                          std::vector<int>& ids) const;
+
 public:
     // Constructor
     SudokuSolver(int N);
@@ -66,8 +198,75 @@ public:
     void solveParallel(int numThreads);
     void solveParallelOptimized(int numThreads, int partitionDepth);
 
+    // First-solution and uniqueness queries (single thread): stop after maxSolutions
+    // solutions, so 1 finds any solution and 2 decides uniqueness. getNumSolutions()
+    // is the number found (at most maxSolutions), getSolution() the first one.
+    // SEARCH_CDCL answers with the clause learning solver, the other engines with
+    // the row-major bitmask search.
+    void solveFirst(long long maxSolutions = 1);
+    // The same with an explicit cell order, value order, seed and restart schedule.
+    // Restarts keep the random stream going, so each run makes different choices;
+    // they need MRV tie-breaks or shuffled values to help.
+    void solveFirst(const SearchConfig& config, long long maxSolutions = 1);
+    long long getNumRestarts() const;
+    bool queryGaveUp() const;  // The last solveFirst stopped at config.nodeLimit
+    const std::vector<int>& getSolution() const;
+
+    // Run one first-solution search per configuration concurrently (one thread each)
+    // and take the answer of the first to finish; the others are cancelled. Any
+    // member gives a complete answer, so maxSolutions = 2 also decides uniqueness.
+    // With statistics enabled, getStats().perThread[i] holds the work of configs[i].
+    void solvePortfolio(const std::vector<SearchConfig>& configs, long long maxSolutions = 1);
+    int getPortfolioWinner() const;
+
+    // Building blocks of solveParallelOptimized, exposed for micro-benchmarks:
+    // the frontier of subproblems at a partition depth, and the solution count of one
+    void generateSubproblems(int partitionDepth, std::vector<Subproblem>& subproblems);
+    long long solveSubproblem(const Subproblem& subproblem);
+
+    // Estimate the size of the solveParallelOptimized search tree with random probes
+    TreeSizeEstimate estimateSearchTree(int numProbes, uint64_t seed) const;
+
+    // Write the remaining frontier and the completed counts of solveParallelOptimized to
+    // path every intervalSeconds (from a timer thread, so long subproblems do not delay
+    // it), and once more at the end. Subproblems in progress are saved as pending, so
+    // after a crash or signal they are searched again from scratch on resume. SIGINT
+    // and SIGTERM stop the run within a few search nodes and write a final checkpoint.
+    // With resume, an existing checkpoint of the same puzzle is continued instead of
+    // starting over, and yields the same final count. An empty path disables
+    // checkpointing.
+    void setCheckpointing(const std::string& path, double intervalSeconds = 60.0, bool resume = true);
+    // False if the last solveParallelOptimized was stopped by a signal (getNumSolutions()
+    // is then the partial count) or could not use its checkpoint file
+    bool isComplete() const;
+
+    // Run solveParallelOptimized NUMA-aware: threads are pinned as placeThreads() lays
+    // them out, the frontier is split into one shard per node that a thread of the node
+    // copies (so its pages are first touched locally), and each thread drains its own
+    // node's shard before stealing from the nearest other nodes. Every thread,
+    // including the caller, gets its previous affinity back when the run ends.
+    void setNumaAware(bool enabled);
+
+    // Print progress and ETA to stderr during solveParallelOptimized
+    void setProgressReporting(bool enabled, double intervalSeconds = 1.0, int probesPerSubproblem = 64);
+
+    // Search statistics (nodes, backtracks, busy/idle time per thread)
+    void setCollectStats(bool enabled);
+    const SolverStats& getStats() const;
+
+    // Hardware counters per thread around frontier generation and solving;
+    // results go to getStats() and stay "not counted" where unavailable
+    void setPerfCounters(bool enabled);
+
+    // Record a per-thread timeline of the parallel solvers (nullptr disables)
+    void setTracer(Tracer* tracer);
+
+    // Search used for subproblems (solveParallelOptimized, solveSubproblem) and solveFirst
+    void setSearchEngine(SearchEngine engine);
+    SearchEngine getSearchEngine() const;
+
     // Query methods
-    int getNumSolutions() const;
+    long long getNumSolutions() const;
     double getRunningTime() const;
     int getSize() const;
     int getBlockSize() const;
@@ -0,0 +1,521 @@
+#include "symmetry_counter.h"
+#include "sudoku_solver.h"
+#include "bit_utils.h"
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <omp.h>
+
+const char* symmetryMethodName(SymmetryMethod method) {
+    switch (method) {
+        case SYMMETRY_RELABEL: return "relabel";
+        case SYMMETRY_GEOMETRIC: return "geometric";
+        case SYMMETRY_BANDS: return "bands";
+        default: return "none";
+    }
+}
+
+std::string uint128ToString(unsigned __int128 value) {
+    if (value == 0) {
+        return "0";
+    }
+    std::string digits;
+    while (value > 0) {
+        digits.push_back(static_cast<char>('0' + static_cast<int>(value % 10)));
+        value /= 10;
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+SymmetryCounter::SymmetryCounter(int N, int numThreads)
+    : N(N), numThreads(std::max(1, numThreads)), frontierDepth(3) {
+    blockSize = static_cast<int>(sqrt(N));
+}
+
+void SymmetryCounter::setFrontierDepth(int depth) {
+    frontierDepth = std::max(0, depth);
+}
+
+// ---------------------------------------------------------------------------
+// Enumeration with relabeling or band/stack symmetry
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Fixed parameters of one enumeration
+struct EnumContext {
+    int N;
+    int blockSize;
+    uint64_t unusedMask;                             // Interchangeable digits (relabel method)
+    const std::vector<std::vector<int>>* images;     // Per symmetry: source cell of each cell, or null
+};
+
+// A partial completion; copies of it are the subproblems handed to threads
+struct EnumState {
+    std::vector<int> board;
+    BitMaskState state;
+    uint64_t seenUnused;    // Unused digits placed so far (always the lowest ones)
+    int pos;                // Next cell in row-major order
+    int filled;             // Empty cells filled so far
+    long long nodes;
+    unsigned long long representatives;
+
+    EnumState(int N) : board(), state(N), seenUnused(0), pos(0), filled(0), nodes(0), representatives(0) {}
+};
+
+// Compare the board with its image under one symmetry on the decided prefix.
+// Returns -1 if the board is smaller, 1 if larger, 0 if equal or undecided.
+int compareWithImage(const std::vector<int>& board, const std::vector<int>& image) {
+    for (size_t cell = 0; cell < board.size(); ++cell) {
+        int own = board[cell];
+        int mapped = board[image[cell]];
+        if (own == 0 || mapped == 0) {
+            return 0;
+        }
+        if (own != mapped) {
+            return (own < mapped) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// False once some image is known to be lexicographically smaller than the board
+bool mayBeLeader(const std::vector<int>& board, const std::vector<std::vector<int>>& images) {
+    for (const std::vector<int>& image : images) {
+        if (compareWithImage(board, image) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Count the canonical completions below st, weighted by orbit size. With a frontier,
+// states that have filled depthLimit empty cells are collected instead of searched.
+unsigned long long enumerate(const EnumContext& ctx, EnumState& st,
+                             std::vector<EnumState>* frontier, int depthLimit) {
+    const int N = ctx.N;
+    const int totalCells = N * N;
+
+    // Skip givens; a completed row decides more of the lexicographic comparisons
+    int pos = st.pos;
+    for (;;) {
+        if (ctx.images != nullptr && pos % N == 0 && pos > 0 && !mayBeLeader(st.board, *ctx.images)) {
+            return 0;
+        }
+        if (pos == totalCells || st.board[pos] == 0) {
+            break;
+        }
+        ++pos;
+    }
+
+    if (pos == totalCells) {
+        st.representatives++;
+        if (ctx.images == nullptr) {
+            return 1;
+        }
+        // Orbit size is |H| / |stabilizer|
+        unsigned long long fixedBy = 1;
+        for (const std::vector<int>& image : *ctx.images) {
+            bool fixes = true;
+            for (int cell = 0; cell < totalCells && fixes; ++cell) {
+                fixes = st.board[cell] == st.board[image[cell]];
+            }
+            fixedBy += fixes ? 1 : 0;
+        }
+        return (ctx.images->size() + 1) / fixedBy;
+    }
+
+    if (frontier != nullptr && st.filled == depthLimit) {
+        frontier->push_back(st);
+        frontier->back().pos = pos;
+        frontier->back().nodes = 0;
+        frontier->back().representatives = 0;
+        return 0;
+    }
+
+    int row = pos / N;
+    int col = pos % N;
+    uint64_t mask = st.state.candidates(N, ctx.blockSize, row, col);
+    // An unused digit may only be placed once all smaller unused digits appear
+    uint64_t unseen = ctx.unusedMask & ~st.seenUnused;
+    if (unseen != 0) {
+        mask &= ~unseen | (unseen & (~unseen + 1));
+    }
+
+    unsigned long long count = 0;
+    uint64_t savedSeen = st.seenUnused;
+    while (mask != 0) {
+        int value = lowestBit64(mask);
+        mask &= mask - 1;
+        st.nodes++;
+        st.board[pos] = value;
+        st.state.set(N, ctx.blockSize, row, col, value);
+        st.seenUnused = savedSeen | (ctx.unusedMask & (1ull << value));
+        st.pos = pos + 1;
+        st.filled++;
+        count += enumerate(ctx, st, frontier, depthLimit);
+        st.filled--;
+        st.state.unset(N, ctx.blockSize, row, col, value);
+        st.board[pos] = 0;
+    }
+    st.seenUnused = savedSeen;
+    st.pos = pos;
+    return count;
+}
+
+} // namespace
+
+// Band and stack permutations (other than the identity) that map the givens onto
+// equal givens. images[h][cell] is the cell whose value moves to cell under h.
+void SymmetryCounter::findGeometricSymmetries(const std::vector<int>& board,
+                                              std::vector<std::vector<int>>& images) const {
+    images.clear();
+    // (blockSize!)^2 candidates of N*N cells each; 14400 for 25x25 is the practical limit
+    if (blockSize > 5) {
+        return;
+    }
+    std::vector<int> bands(blockSize), stacks(blockSize);
+    for (int i = 0; i < blockSize; ++i) {
+        bands[i] = i;
+    }
+    std::vector<int> image(N * N);
+    do {
+        for (int i = 0; i < blockSize; ++i) {
+            stacks[i] = i;
+        }
+        do {
+            bool identity = true;
+            for (int i = 0; i < blockSize; ++i) {
+                identity = identity && bands[i] == i && stacks[i] == i;
+            }
+            if (identity) {
+                continue;
+            }
+            bool fixesGivens = true;
+            for (int cell = 0; cell < N * N && fixesGivens; ++cell) {
+                int row = cell / N;
+                int col = cell % N;
+                int sourceRow = bands[row / blockSize] * blockSize + row % blockSize;
+                int sourceCol = stacks[col / blockSize] * blockSize + col % blockSize;
+                image[cell] = sourceRow * N + sourceCol;
+                fixesGivens = board[cell] == board[image[cell]];
+            }
+            if (fixesGivens) {
+                images.push_back(image);
+            }
+        } while (std::next_permutation(stacks.begin(), stacks.end()));
+    } while (std::next_permutation(bands.begin(), bands.end()));
+}
+
+// Enumerate canonical completions: the search runs serially to frontierDepth filled
+// cells, then the collected subproblems are shared out dynamically across threads
+unsigned __int128 SymmetryCounter::countByEnumeration(const std::vector<int>& board, uint64_t unusedMask,
+                                                      const std::vector<std::vector<int>>& images,
+                                                      unsigned __int128& representatives,
+                                                      long long& nodes) const {
+    EnumContext ctx;
+    ctx.N = N;
+    ctx.blockSize = blockSize;
+    ctx.unusedMask = unusedMask;
+    ctx.images = images.empty() ? nullptr : &images;
+
+    EnumState root(N);
+    root.board = board;
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (board[cell] != 0) {
+            root.state.set(N, blockSize, cell / N, cell % N, board[cell]);
+        }
+    }
+
+    std::vector<EnumState> frontier;
+    unsigned __int128 total = enumerate(ctx, root, &frontier, frontierDepth);
+    unsigned long long leaders = root.representatives;
+    long long totalNodes = root.nodes;
+
+    unsigned long long frontierTotal = 0;
+    int numSubproblems = static_cast<int>(frontier.size());
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(numThreads) reduction(+:frontierTotal, leaders, totalNodes)
+    for (int i = 0; i < numSubproblems; ++i) {
+        frontierTotal += enumerate(ctx, frontier[i], nullptr, 0);
+        leaders += frontier[i].representatives;
+        totalNodes += frontier[i].nodes;
+    }
+
+    representatives = leaders;
+    nodes = totalNodes;
+    return total + frontierTotal;
+}
+
+// ---------------------------------------------------------------------------
+// Band decomposition of the empty 9x9 grid
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const uint16_t ALL_DIGITS = 0x1FF;   // Digits 1..9 as bits 0..8
+const int PERMS3[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+// Column sets of one band: digits of each of the 9 columns
+typedef std::array<uint16_t, 9> ColumnSets;
+// Column sets of one stack, partitioning the digits
+typedef std::array<uint16_t, 3> StackSets;
+
+// Ordered partitions of the digits into three column sets, where column k avoids avoid[k]
+void stackPartitions(const std::vector<uint16_t>& triples, const uint16_t* avoid, std::vector<StackSets>& out) {
+    out.clear();
+    for (uint16_t first : triples) {
+        if (first & avoid[0]) {
+            continue;
+        }
+        for (uint16_t second : triples) {
+            if (second & (first | avoid[1])) {
+                continue;
+            }
+            uint16_t third = ALL_DIGITS & ~(first | second);
+            if (!(third & avoid[2])) {
+                out.push_back({first, second, third});
+            }
+        }
+    }
+}
+
+// Column of each digit within each stack
+void digitColumns(const ColumnSets& sets, int columns[9][3]) {
+    for (int stack = 0; stack < 3; ++stack) {
+        for (int k = 0; k < 3; ++k) {
+            for (uint16_t digits = sets[stack * 3 + k]; digits != 0; digits &= digits - 1) {
+                columns[lowestBit64(digits)][stack] = k;
+            }
+        }
+    }
+}
+
+// The band's column sets up to relabeling: 2-bit counts of the digits in each
+// (stack 1 column, stack 2 column, stack 3 column) triple
+uint64_t tensorKey(const ColumnSets& sets) {
+    int columns[9][3];
+    digitColumns(sets, columns);
+    uint64_t key = 0;
+    for (int digit = 0; digit < 9; ++digit) {
+        key += 1ull << (2 * (columns[digit][0] * 9 + columns[digit][1] * 3 + columns[digit][2]));
+    }
+    return key;
+}
+
+// Least key over permutations of the stacks and of the columns within each stack
+uint64_t canonicalKey(uint64_t key) {
+    int counts[27];
+    for (int i = 0; i < 27; ++i) {
+        counts[i] = static_cast<int>((key >> (2 * i)) & 3);
+    }
+    uint64_t best = key;
+    for (const int* axes : PERMS3) {
+        for (const int* p0 : PERMS3) {
+            for (const int* p1 : PERMS3) {
+                for (const int* p2 : PERMS3) {
+                    uint64_t mapped = 0;
+                    for (int i = 0; i < 27; ++i) {
+                        if (counts[i] == 0) {
+                            continue;
+                        }
+                        int coords[3] = {i / 9, (i / 3) % 3, i % 3};
+                        int index = p0[coords[axes[0]]] * 9 + p1[coords[axes[1]]] * 3 + p2[coords[axes[2]]];
+                        mapped += static_cast<uint64_t>(counts[i]) << (2 * index);
+                    }
+                    best = std::min(best, mapped);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// Number of bands with the given column sets: each digit picks the row it takes in
+// every stack (a permutation of the three rows), and no cell may be taken twice
+uint64_t countBandFillings(const int columns[9][3], uint8_t* usedRows, int digit) {
+    if (digit == 9) {
+        return 1;
+    }
+    uint64_t count = 0;
+    for (const int* rows : PERMS3) {
+        bool fits = true;
+        for (int stack = 0; stack < 3 && fits; ++stack) {
+            fits = !(usedRows[stack * 3 + columns[digit][stack]] & (1 << rows[stack]));
+        }
+        if (!fits) {
+            continue;
+        }
+        for (int stack = 0; stack < 3; ++stack) {
+            usedRows[stack * 3 + columns[digit][stack]] |= static_cast<uint8_t>(1 << rows[stack]);
+        }
+        count += countBandFillings(columns, usedRows, digit + 1);
+        for (int stack = 0; stack < 3; ++stack) {
+            usedRows[stack * 3 + columns[digit][stack]] &= static_cast<uint8_t>(~(1 << rows[stack]));
+        }
+    }
+    return count;
+}
+
+// Per-band counts memoized by symmetry class of the column sets
+class BandTable {
+public:
+    struct Entry {
+        uint64_t fillings;      // Bands with these column sets
+        uint64_t completions;   // Ways to fill the other two bands (valid if hasCompletions)
+        bool hasCompletions;
+    };
+
+    Entry& lookup(const ColumnSets& sets) {
+        uint64_t raw = tensorKey(sets);
+        auto known = canonical.find(raw);
+        if (known == canonical.end()) {
+            known = canonical.emplace(raw, canonicalKey(raw)).first;
+        }
+        auto entry = classes.find(known->second);
+        if (entry == classes.end()) {
+            int columns[9][3];
+            digitColumns(sets, columns);
+            uint8_t usedRows[9] = {0};
+            Entry fresh = {countBandFillings(columns, usedRows, 0), 0, false};
+            entry = classes.emplace(known->second, fresh).first;
+        }
+        return entry->second;
+    }
+
+private:
+    std::unordered_map<uint64_t, uint64_t> canonical;   // Raw key -> canonical key
+    std::unordered_map<uint64_t, Entry> classes;        // Canonical key -> counts
+};
+
+} // namespace
+
+// total = 1680 * sum over first-band column sets S1 (first stack fixed) of
+//         g(S1) * sum over second-band column sets S2 of g(S2) * g(S3),
+// where g counts the bands with given column sets and S3 is what S1 and S2 leave
+unsigned __int128 SymmetryCounter::countEmpty9x9(long long& nodes) const {
+    std::vector<uint16_t> triples;
+    for (uint16_t digits = 0; digits <= ALL_DIGITS; ++digits) {
+        if (popcount64(digits) == 3) {
+            triples.push_back(digits);
+        }
+    }
+    const uint16_t none[3] = {0, 0, 0};
+    std::vector<StackSets> anyStack;
+    stackPartitions(triples, none, anyStack);
+
+    BandTable table;
+    nodes = 0;
+    unsigned __int128 total = 0;
+    ColumnSets first = {0x007, 0x038, 0x1C0, 0, 0, 0, 0, 0, 0};
+    std::vector<StackSets> secondStacks[3];
+    for (const StackSets& stack2 : anyStack) {
+        for (const StackSets& stack3 : anyStack) {
+            std::copy(stack2.begin(), stack2.end(), first.begin() + 3);
+            std::copy(stack3.begin(), stack3.end(), first.begin() + 6);
+            nodes++;
+            BandTable::Entry& firstEntry = table.lookup(first);
+            if (firstEntry.fillings == 0) {
+                continue;
+            }
+            if (!firstEntry.hasCompletions) {
+                // Second band: each stack's column sets avoid the first band's
+                for (int stack = 0; stack < 3; ++stack) {
+                    stackPartitions(triples, &first[stack * 3], secondStacks[stack]);
+                }
+                uint64_t completions = 0;
+                ColumnSets second, third;
+                for (const StackSets& a : secondStacks[0]) {
+                    for (const StackSets& b : secondStacks[1]) {
+                        for (const StackSets& c : secondStacks[2]) {
+                            std::copy(a.begin(), a.end(), second.begin());
+                            std::copy(b.begin(), b.end(), second.begin() + 3);
+                            std::copy(c.begin(), c.end(), second.begin() + 6);
+                            for (int col = 0; col < 9; ++col) {
+                                third[col] = ALL_DIGITS & ~(first[col] | second[col]);
+                            }
+                            nodes++;
+                            uint64_t secondFillings = table.lookup(second).fillings;
+                            if (secondFillings != 0) {
+                                completions += secondFillings * table.lookup(third).fillings;
+                            }
+                        }
+                    }
+                }
+                // unordered_map keeps references valid across the inserts above
+                firstEntry.completions = completions;
+                firstEntry.hasCompletions = true;
+            }
+            total += static_cast<unsigned __int128>(firstEntry.fillings) * firstEntry.completions;
+        }
+    }
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+
+bool SymmetryCounter::count(const std::vector<int>& board, SymmetryCount& result) const {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (blockSize * blockSize != N || N > 63 || static_cast<int>(board.size()) != N * N) {
+        std::cerr << "Error: symmetry counting needs a square board of size at most 49" << std::endl;
+        return false;
+    }
+
+    BitMaskState givens(N);
+    uint64_t usedDigits = 0;
+    int numGivens = 0;
+    for (int cell = 0; cell < N * N; ++cell) {
+        int value = board[cell];
+        if (value == 0) {
+            continue;
+        }
+        if (value < 0 || value > N || !givens.canPlace(N, blockSize, cell / N, cell % N, value)) {
+            std::cerr << "Error: invalid or conflicting given at cell " << cell << std::endl;
+            return false;
+        }
+        givens.set(N, blockSize, cell / N, cell % N, value);
+        usedDigits |= 1ull << value;
+        numGivens++;
+    }
+    uint64_t allDigits = ((1ull << (N + 1)) - 1) & ~1ull;
+    uint64_t unusedMask = allDigits & ~usedDigits;
+
+    result.unusedDigits = popcount64(unusedMask);
+    result.geometricSymmetries = 1;
+    result.nodes = 0;
+
+    std::vector<std::vector<int>> images;
+    if (N == 9 && numGivens == 0) {
+        result.method = SYMMETRY_BANDS;
+        result.orbitSize = 1680;
+        result.representatives = countEmpty9x9(result.nodes);
+        result.solutions = result.representatives * result.orbitSize;
+    } else if (result.unusedDigits >= 2) {
+        unsigned __int128 factorial = 1;
+        for (int k = 2; k <= result.unusedDigits; ++k) {
+            if (factorial > ~static_cast<unsigned __int128>(0) / k) {
+                std::cerr << "Error: " << result.unusedDigits << "! does not fit in 128 bits" << std::endl;
+                return false;
+            }
+            factorial *= k;
+        }
+        result.method = SYMMETRY_RELABEL;
+        result.orbitSize = factorial;
+        result.solutions = countByEnumeration(board, unusedMask, images, result.representatives, result.nodes)
+                           * factorial;
+    } else {
+        findGeometricSymmetries(board, images);
+        result.geometricSymmetries = static_cast<int>(images.size()) + 1;
+        result.method = images.empty() ? SYMMETRY_NONE : SYMMETRY_GEOMETRIC;
+        result.orbitSize = result.geometricSymmetries;
+        result.solutions = countByEnumeration(board, 0, images, result.representatives, result.nodes);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    result.timeMs = std::chrono::duration<double, std::milli>(end - start).count();
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef SYMMETRY_COUNTER_H
+#define SYMMETRY_COUNTER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// How SymmetryCounter::count reduced the search
+enum SymmetryMethod {
+    SYMMETRY_NONE,        // No symmetry left by the givens: plain enumeration
+    SYMMETRY_RELABEL,     // Digits missing from the givens are interchangeable
+    SYMMETRY_GEOMETRIC,   // Band and stack permutations that map the givens onto themselves
+    SYMMETRY_BANDS        // Empty 9x9 grid: band decomposition over column sets
+};
+
+// Human-readable method name
+const char* symmetryMethodName(SymmetryMethod method);
+
+// Decimal representation of a 128-bit count
+std::string uint128ToString(unsigned __int128 value);
+
+// Result of one symmetry-reduced count
+struct SymmetryCount {
+    SymmetryMethod method;
+    unsigned __int128 solutions;         // Total number of completions
+    unsigned __int128 representatives;   // Canonical completions actually counted
+    unsigned __int128 orbitSize;         // Size of the symmetry group (largest orbit)
+    int unusedDigits;                    // Digits that do not occur in the givens
+    int geometricSymmetries;             // Band/stack permutations fixing the givens (identity included)
+    long long nodes;                     // Search nodes (band method: column set configurations examined)
+    double timeMs;
+};
+
+// Counts all completions of a board, exploiting the symmetries its givens leave
+// intact. The count of each orbit of completions is taken from one canonical member:
+// - Relabeling: permuting the k digits absent from the givens maps completions to
+//   completions, and only the identity fixes a completed grid, so every orbit has
+//   k! members. Only completions whose unused digits first appear (row-major) in
+//   ascending order are counted, and the count is multiplied by k!.
+// - Band/stack permutations: a permutation of bands and of stacks that maps every
+//   given onto an equal given maps completions to completions. Only completions that
+//   are lexicographically least (row-major) among their images are enumerated; each
+//   adds |H| / |stabilizer| because some grids are fixed by a swap of bands and
+//   stacks (e.g. 1234/4321/3412/2143).
+// The two kinds are not combined; relabeling is preferred when at least two digits
+// are unused.
+// - The empty 9x9 grid uses the band decomposition: a band's column sets determine
+//   how many ways the other bands can be filled, so the count is a sum over column
+//   set configurations of products of per-band counts, with the first stack's column
+//   sets fixed by relabeling (factor 1680).
+class SymmetryCounter {
+private:
+    int N;              // Size of the board (N x N)
+    int blockSize;      // Size of each block (sqrt(N))
+    int numThreads;
+    int frontierDepth;  // Empty cells filled before the search is split across threads
+
+    void findGeometricSymmetries(const std::vector<int>& board, std::vector<std::vector<int>>& images) const;
+    unsigned __int128 countByEnumeration(const std::vector<int>& board, uint64_t unusedMask,
+                                         const std::vector<std::vector<int>>& images,
+                                         unsigned __int128& representatives, long long& nodes) const;
+    unsigned __int128 countEmpty9x9(long long& nodes) const;
+
+public:
+    SymmetryCounter(int N, int numThreads);
+
+    void setFrontierDepth(int depth);
+
+    // Count the completions of board (0 = empty cell). Returns false if the board
+    // size is unsupported or the givens conflict.
+    bool count(const std::vector<int>& board, SymmetryCount& result) const;
+};
+
+#endif // SYMMETRY_COUNTER_H
@@ -0,0 +1,347 @@
+#include "system_info.h"
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <sstream>
+#include <omp.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifndef SUDOKU_COMPILE_FLAGS
+#define SUDOKU_COMPILE_FLAGS "unknown"
+#endif
+
+// Value of a "key : value" line from /proc/cpuinfo
+static std::string cpuinfoValue(const std::string& line) {
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+        return "";
+    }
+    size_t start = line.find_first_not_of(" \t", colon + 1);
+    return (start == std::string::npos) ? "" : line.substr(start);
+}
+
+// Collect CPU, core count and build information
+SystemInfo collectSystemInfo() {
+    SystemInfo info;
+    info.cpuModel = "unknown";
+    info.logicalCpus = static_cast<int>(std::thread::hardware_concurrency());
+    info.physicalCores = 0;
+
+    // Cores are distinct (physical id, core id) pairs
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::set<std::pair<std::string, std::string>> cores;
+    std::string line, physicalId;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0 && info.cpuModel == "unknown") {
+            info.cpuModel = cpuinfoValue(line);
+        } else if (line.compare(0, 11, "physical id") == 0) {
+            physicalId = cpuinfoValue(line);
+        } else if (line.compare(0, 7, "core id") == 0) {
+            cores.insert(std::make_pair(physicalId, cpuinfoValue(line)));
+        }
+    }
+    info.physicalCores = static_cast<int>(cores.size());
+
+#if defined(__clang__)
+    info.compiler = "Clang " __clang_version__;
+#elif defined(__GNUC__)
+    info.compiler = "GCC " __VERSION__;
+#elif defined(_MSC_VER)
+    info.compiler = "MSVC " + std::to_string(_MSC_VER);
+#else
+    info.compiler = "unknown";
+#endif
+    info.compileFlags = SUDOKU_COMPILE_FLAGS;
+
+    return info;
+}
+
+// Read the first integer of a sysfs file, -1 if missing
+static int readSysfsInt(const std::string& path) {
+    std::ifstream file(path);
+    int value = -1;
+    if (!(file >> value)) {
+        return -1;
+    }
+    return value;
+}
+
+// Parse a sysfs CPU or node list such as "0-3,8,10-11"
+static std::vector<int> parseSysfsList(const std::string& path) {
+    std::vector<int> values;
+    std::ifstream file(path);
+    std::string list, range;
+    if (!std::getline(file, list)) {
+        return values;
+    }
+    std::stringstream ranges(list);
+    while (std::getline(ranges, range, ',')) {
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (int value = first; value <= last; ++value) {
+                values.push_back(value);
+            }
+        } catch (const std::exception&) {
+            return std::vector<int>();
+        }
+    }
+    return values;
+}
+
+// Fill in the NUMA node of every CPU from /sys/devices/system/node. Without it (or
+// on other systems) all CPUs form node 0 at distance 10, the local sysfs distance.
+static void detectNumaNodes(CpuTopology& topology) {
+    const std::string root = "/sys/devices/system/node/";
+    std::vector<int> online = parseSysfsList(root + "online");
+    std::map<int, int> nodeOfCpu;
+    for (int node : online) {
+        for (int cpu : parseSysfsList(root + "node" + std::to_string(node) + "/cpulist")) {
+            nodeOfCpu[cpu] = node;
+        }
+    }
+
+    std::set<int> usedNodes;
+    topology.nodes.clear();
+    for (int cpu : topology.cpus) {
+        auto found = nodeOfCpu.find(cpu);
+        int node = (found == nodeOfCpu.end()) ? 0 : found->second;
+        topology.nodes.push_back(node);
+        usedNodes.insert(node);
+    }
+    topology.nodeIds.assign(usedNodes.begin(), usedNodes.end());
+
+    // nodeX/distance lists the distance to every online node in id order
+    size_t numNodes = topology.nodeIds.size();
+    topology.nodeDistance.assign(numNodes, std::vector<int>(numNodes, 20));
+    for (size_t i = 0; i < numNodes; ++i) {
+        topology.nodeDistance[i][i] = 10;
+        std::ifstream file(root + "node" + std::to_string(topology.nodeIds[i]) + "/distance");
+        std::map<int, int> distanceTo;
+        int distance = 0;
+        for (size_t k = 0; k < online.size() && file >> distance; ++k) {
+            distanceTo[online[k]] = distance;
+        }
+        for (size_t j = 0; j < numNodes; ++j) {
+            auto found = distanceTo.find(topology.nodeIds[j]);
+            if (found != distanceTo.end()) {
+                topology.nodeDistance[i][j] = found->second;
+            }
+        }
+    }
+}
+
+static CpuTopology detectCpuTopology() {
+    CpuTopology topology;
+    topology.numCores = 0;
+    std::vector<int> allowedCpus;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                allowedCpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (allowedCpus.empty()) {
+        int count = std::max(1u, std::thread::hardware_concurrency());
+        for (int cpu = 0; cpu < count; ++cpu) {
+            allowedCpus.push_back(cpu);
+        }
+    }
+
+    // Rank of every CPU among the siblings of its (package, core); rank 0 first
+    std::map<std::pair<int, int>, int> siblingsSeen;
+    std::vector<std::pair<int, int>> ranked;  // (sibling rank, cpu)
+    for (int cpu : allowedCpus) {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        int package = readSysfsInt(base + "physical_package_id");
+        int core = readSysfsInt(base + "core_id");
+        std::pair<int, int> key = (core < 0) ? std::make_pair(-1, cpu) : std::make_pair(package, core);
+        ranked.push_back(std::make_pair(siblingsSeen[key]++, cpu));
+    }
+    std::sort(ranked.begin(), ranked.end());
+
+    for (const auto& entry : ranked) {
+        topology.cpus.push_back(entry.second);
+    }
+    topology.numCores = static_cast<int>(siblingsSeen.size());
+    detectNumaNodes(topology);
+    return topology;
+}
+
+const CpuTopology& getCpuTopology() {
+    static const CpuTopology topology = detectCpuTopology();
+    return topology;
+}
+
+// Pin each thread of the OpenMP team. libgomp reuses the same pool threads for
+// later regions of the same size, so the pinning carries over to the solver.
+bool pinThreads(int numThreads) {
+#ifdef __linux__
+    const std::vector<int>& cpus = getCpuTopology().cpus;
+
+    bool pinned = true;
+    omp_set_num_threads(numThreads);
+    #pragma omp parallel reduction(&&:pinned)
+    {
+        cpu_set_t target;
+        CPU_ZERO(&target);
+        CPU_SET(cpus[omp_get_thread_num() % cpus.size()], &target);
+        pinned = sched_setaffinity(0, sizeof(target), &target) == 0;
+    }
+    return pinned;
+#else
+    (void)numThreads;
+    std::cerr << "Warning: Thread pinning is only supported on Linux" << std::endl;
+    return false;
+#endif
+}
+
+// Deal the threads round robin over the nodes with allowed CPUs
+ThreadPlacement placeThreads(int numThreads) {
+    const CpuTopology& topology = getCpuTopology();
+    size_t numNodes = topology.nodeIds.size();
+    std::vector<std::vector<int>> nodeCpus(numNodes);
+    for (size_t i = 0; i < topology.cpus.size(); ++i) {
+        size_t node = std::lower_bound(topology.nodeIds.begin(), topology.nodeIds.end(), topology.nodes[i])
+                    - topology.nodeIds.begin();
+        nodeCpus[node].push_back(topology.cpus[i]);
+    }
+
+    ThreadPlacement placement;
+    size_t usedNodes = std::min(numNodes, static_cast<size_t>(std::max(1, numThreads)));
+    for (int thread = 0; thread < numThreads; ++thread) {
+        size_t node = thread % usedNodes;
+        const std::vector<int>& cpus = nodeCpus[node];
+        placement.cpus.push_back(cpus[(thread / usedNodes) % cpus.size()]);
+        placement.nodes.push_back(static_cast<int>(node));
+    }
+    placement.nodeIds.assign(topology.nodeIds.begin(), topology.nodeIds.begin() + usedNodes);
+
+    // Other nodes nearest first; ties go to the lower id
+    placement.stealOrder.resize(usedNodes);
+    for (size_t node = 0; node < usedNodes; ++node) {
+        std::vector<std::pair<int, int>> others;  // (distance, node)
+        for (size_t other = 0; other < usedNodes; ++other) {
+            if (other != node) {
+                others.push_back(std::make_pair(topology.nodeDistance[node][other], static_cast<int>(other)));
+            }
+        }
+        std::sort(others.begin(), others.end());
+        for (const auto& entry : others) {
+            placement.stealOrder[node].push_back(entry.second);
+        }
+    }
+    return placement;
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+    cpu_set_t target;
+    CPU_ZERO(&target);
+    CPU_SET(cpu, &target);
+    return sched_setaffinity(0, sizeof(target), &target) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+std::vector<int> getCurrentThreadCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+bool setCurrentThreadCpus(const std::vector<int>& cpus) {
+#ifdef __linux__
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t target;
+    CPU_ZERO(&target);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &target);
+    }
+    return sched_setaffinity(0, sizeof(target), &target) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// Collapse runs of consecutive CPUs into ranges
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::string list;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t end = i;
+        while (end + 1 < cpus.size() && cpus[end + 1] == cpus[end] + 1) {
+            ++end;
+        }
+        if (!list.empty()) {
+            list += ",";
+        }
+        list += std::to_string(cpus[i]);
+        if (end > i) {
+            list += "-" + std::to_string(cpus[end]);
+        }
+        i = end + 1;
+    }
+    return list;
+}
+
+std::string describeNumaLayout() {
+    const CpuTopology& topology = getCpuTopology();
+    std::string layout = std::to_string(topology.nodeIds.size()) + " NUMA node"
+                       + (topology.nodeIds.size() == 1 ? "" : "s") + " (";
+    for (size_t i = 0; i < topology.nodeIds.size(); ++i) {
+        std::vector<int> cpus;
+        for (size_t k = 0; k < topology.cpus.size(); ++k) {
+            if (topology.nodes[k] == topology.nodeIds[i]) {
+                cpus.push_back(topology.cpus[k]);
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+        layout += (i > 0 ? "; node" : "node") + std::to_string(topology.nodeIds[i]) + ": cpus " + formatCpuList(cpus);
+    }
+    return layout + ")";
+}
+
+// Thread counts for a scaling sweep
+std::vector<int> scalingThreadCounts(int maxThreads) {
+    std::vector<int> counts;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    int cores = getCpuTopology().numCores;
+    if (cores <= maxThreads) {
+        counts.push_back(cores);
+    }
+    counts.push_back(std::max(1, maxThreads));
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    return counts;
+}
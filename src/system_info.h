@@ -0,0 +1,67 @@
+#ifndef SYSTEM_INFO_H
+#define SYSTEM_INFO_H
+
+#include <string>
+#include <vector>
+
+// Description of the machine and build a benchmark ran on
+struct SystemInfo {
+    std::string cpuModel;      // e.g. "Intel(R) Xeon(R) ..." ("unknown" if not found)
+    int logicalCpus;           // Hardware threads available to the process
+    int physicalCores;         // Distinct cores (0 if unknown)
+    std::string compiler;      // Compiler name and version
+    std::string compileFlags;  // Optimization and OpenMP flags passed in by CMake
+};
+
+// Collect the information above
+SystemInfo collectSystemInfo();
+
+// CPUs the process may run on, grouped by physical core (Linux sysfs)
+struct CpuTopology {
+    std::vector<int> cpus;   // One CPU of every core first, then the SMT siblings
+    int numCores;            // Distinct physical cores among them
+    std::vector<int> nodes;  // NUMA node of each entry of cpus (0 without sysfs)
+    std::vector<int> nodeIds;  // Nodes with at least one allowed CPU, ascending
+    std::vector<std::vector<int>> nodeDistance;  // sysfs distance between nodeIds entries
+};
+
+// Topology of the CPUs allowed at the first call (later calls return the same result,
+// so pinning does not shrink it). Without sysfs every CPU counts as its own core.
+const CpuTopology& getCpuTopology();
+
+// Pin OpenMP thread i of a numThreads team to the i-th CPU of getCpuTopology().cpus
+// (round robin), so the first numCores threads get a core each before any thread
+// shares a core with an SMT sibling. Returns false where affinity is not supported.
+bool pinThreads(int numThreads);
+
+// Where every thread of a team runs. Threads are dealt round robin over the NUMA
+// nodes (thread t on node t % numNodes), and within a node take its CPUs in
+// getCpuTopology() order, so every node gets threads and cores before SMT siblings.
+struct ThreadPlacement {
+    std::vector<int> cpus;   // CPU of every thread
+    std::vector<int> nodes;  // Node of every thread, as an index into nodeIds
+    std::vector<int> nodeIds;  // sysfs ids of the nodes that received threads
+    std::vector<std::vector<int>> stealOrder;  // Per node: the other nodes, nearest first
+};
+ThreadPlacement placeThreads(int numThreads);
+
+// Pin the calling thread to one CPU. Returns false where affinity is not supported.
+bool pinCurrentThread(int cpu);
+
+// CPUs the calling thread may run on, to undo a pinCurrentThread() later with
+// setCurrentThreadCpus(). Empty where affinity is not supported.
+std::vector<int> getCurrentThreadCpus();
+bool setCurrentThreadCpus(const std::vector<int>& cpus);
+
+// "0-3,8,10-11" for a sorted CPU list
+std::string formatCpuList(const std::vector<int>& cpus);
+
+// NUMA nodes of getCpuTopology() and their allowed CPUs, e.g.
+// "2 NUMA nodes (node0: cpus 0-7; node1: cpus 8-15)"
+std::string describeNumaLayout();
+
+// Thread counts for a scaling sweep: powers of two up to maxThreads, plus the
+// physical core count and maxThreads itself when they are not powers of two
+std::vector<int> scalingThreadCounts(int maxThreads);
+
+#endif // SYSTEM_INFO_H
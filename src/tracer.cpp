@@ -0,0 +1,100 @@
+#include "tracer.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+// Constructor
+Tracer::Tracer(int maxThreads, size_t eventsPerThread)
+    : buffers(std::max(1, maxThreads)), capacity(std::max<size_t>(1, eventsPerThread)),
+      origin(std::chrono::steady_clock::now()) {
+    for (ThreadBuffer& buffer : buffers) {
+        buffer.events.resize(capacity);
+        buffer.written = 0;
+    }
+}
+
+// Microseconds since the origin
+double Tracer::nowUs() const {
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - origin;
+    return elapsed.count();
+}
+
+// Record an event into the thread's ring buffer
+void Tracer::record(int thread, const char* name, const char* category,
+                    double startUs, double endUs, long long arg) {
+    if (thread < 0 || thread >= static_cast<int>(buffers.size())) {
+        return;
+    }
+    ThreadBuffer& buffer = buffers[thread];
+    TraceEvent& event = buffer.events[buffer.written % capacity];
+    event.name = name;
+    event.category = category;
+    event.startUs = startUs;
+    event.durationUs = endUs - startUs;
+    event.arg = arg;
+    buffer.written++;
+}
+
+// Write Chrome trace-event JSON
+bool Tracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create trace file " << path << std::endl;
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"sudoku solver\"}}";
+
+    out << std::fixed << std::setprecision(3);
+    for (size_t thread = 0; thread < buffers.size(); ++thread) {
+        const ThreadBuffer& buffer = buffers[thread];
+        if (buffer.written == 0) {
+            continue;
+        }
+
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+            << ",\"args\":{\"name\":\"thread " << thread << "\"}}";
+
+        // Oldest surviving event first
+        size_t count = std::min(buffer.written, capacity);
+        size_t first = buffer.written - count;
+        for (size_t i = first; i < buffer.written; ++i) {
+            const TraceEvent& event = buffer.events[i % capacity];
+            out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+                << ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs;
+            if (event.arg >= 0) {
+                out << ",\"args\":{\"value\":" << event.arg << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
+
+// Drop all events and restart the clock
+void Tracer::clear() {
+    for (ThreadBuffer& buffer : buffers) {
+        buffer.written = 0;
+    }
+    origin = std::chrono::steady_clock::now();
+}
+
+// Number of events lost to wraparound
+size_t Tracer::getDroppedEvents() const {
+    size_t dropped = 0;
+    for (const ThreadBuffer& buffer : buffers) {
+        if (buffer.written > capacity) {
+            dropped += buffer.written - capacity;
+        }
+    }
+    return dropped;
+}
+
+int Tracer::getMaxThreads() const {
+    return static_cast<int>(buffers.size());
+}
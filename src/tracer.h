@@ -0,0 +1,80 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+// One timeline event, written as a Chrome trace "complete" (ph = X) event
+struct TraceEvent {
+    const char* name;      // Event name (string literal)
+    const char* category;  // Event category (string literal)
+    double startUs;        // Start time relative to the tracer origin (microseconds)
+    double durationUs;     // Duration (microseconds)
+    long long arg;         // Optional argument (e.g. subproblem index), -1 if unused
+};
+
+// Low-overhead timeline recorder. Each thread writes only to its own ring buffer,
+// so recording needs no locks; when a buffer is full the oldest events are
+// overwritten. The result is written as Chrome trace-event JSON, viewable in
+// chrome://tracing or https://ui.perfetto.dev.
+class Tracer {
+private:
+    struct alignas(64) ThreadBuffer {
+        std::vector<TraceEvent> events;  // Ring storage
+        size_t written;                  // Total events recorded (may exceed capacity)
+    };
+
+    std::vector<ThreadBuffer> buffers;
+    size_t capacity;
+    std::chrono::steady_clock::time_point origin;
+
+public:
+    // Constructor: one ring buffer of eventsPerThread entries for each thread
+    Tracer(int maxThreads, size_t eventsPerThread = 1 << 16);
+
+    // Microseconds since the tracer was created (or last cleared)
+    double nowUs() const;
+
+    // Record an event for the given thread; out-of-range threads are ignored
+    void record(int thread, const char* name, const char* category,
+                double startUs, double endUs, long long arg = -1);
+
+    // Write all buffered events as Chrome trace JSON
+    bool writeChromeTrace(const std::string& path) const;
+
+    // Drop all events and restart the clock
+    void clear();
+
+    // Number of events lost to ring-buffer wraparound
+    size_t getDroppedEvents() const;
+    int getMaxThreads() const;
+};
+
+// Records one event covering its own lifetime; does nothing when tracer is null
+class TraceScope {
+private:
+    Tracer* tracer;
+    int thread;
+    const char* name;
+    const char* category;
+    long long arg;
+    double startUs;
+
+public:
+    TraceScope(Tracer* tracer, int thread, const char* name, const char* category, long long arg = -1)
+        : tracer(tracer), thread(thread), name(name), category(category), arg(arg),
+          startUs(tracer ? tracer->nowUs() : 0.0) {}
+
+    ~TraceScope() {
+        if (tracer) {
+            tracer->record(thread, name, category, startUs, tracer->nowUs(), arg);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#endif // TRACER_H